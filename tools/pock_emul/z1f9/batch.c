@@ -0,0 +1,791 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	ꊇs (libz1core g)
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#define mkdir(path, mode)	_mkdir(path)
+#else
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include "z1.h"
+
+/* }jtFXg1s̍ő咷 */
+#define MANIFEST_LINE	(PATH_MAX + 64)
+
+/* WuƂɖ{̂֓nݒ̍ő吔 */
+#define JOB_SETTINGS	64
+
+/* sXe[g̊l */
+#define JOB_STATES	100000000LL
+
+/*
+	Wu
+*/
+struct Job {
+	/* ݒ */
+	char name[64]; /* O */
+	char rom[PATH_MAX]; /* ROMC[W(Ȃ΋[ROM) */
+	char ram[PATH_MAX]; /* RAMC[W(ȂΏl) */
+	char program[PATH_MAX]; /* vO(wb_toCi) */
+	int start; /* sn߂AhX(Ȃ΃wb_̒l) */
+	char input[PATH_MAX]; /* ͂eLXgt@C */
+	int input_wait; /* ͂n߂܂ł̎(G~[gĂ鎞Ԃms) */
+	int64 states; /* sXe[g̏ */
+	char expect_sio[PATH_MAX]; /* ҂VAo͂̃t@C */
+	char expect_printer[PATH_MAX]; /* ҂v^o͂̃t@C */
+	int expect_lcd_valid; /* LCD̃nbVׂ邩? */
+	uint64 expect_lcd; /* ҂LCD̃nbV */
+	char floppy_dir[PATH_MAX]; /* sOɍ쐬tbs[fBXÑfBNg(Ȃ΍쐬Ȃ) */
+	char *argv[JOB_SETTINGS + 2]; /* {̂̐ݒ(-<>=<l>) */
+	int argc; /* {̂̐ݒ̐+1 */
+
+	/*  */
+	char error[PATH_MAX + 64]; /* G[(Ȃ΋) */
+	uint64 executed; /* sXe[g */
+	int64 wall; /* sɂ(imb) */
+	int off; /* d؂ꂽ? */
+	uint8 *sio; /* VAo */
+	int sio_len; /* VAo͂̒ */
+	uint8 *printer; /* v^o */
+	int printer_len; /* v^o͂̒ */
+	uint64 lcd; /* LCD̃nbV */
+	int sio_ok; /* VAo͂v? */
+	int printer_ok; /* v^o͂v? */
+	int lcd_ok; /* LCD̃nbVv? */
+	int pass; /* i? */
+};
+
+/*
+	[J
+*/
+struct Worker {
+	pthread_t thread; /* Xbh */
+	pthread_mutex_t mutex; /* queue */
+	int *queue; /* Wu̔ԍ̗[L[ */
+	int top; /* ̃[Jވʒu */
+	int bottom; /* oʒu */
+	struct Pool *pool; /* v[ */
+	int index; /* v[̒̔ԍ */
+	int started; /* Xbh쐬? */
+};
+
+/*
+	[J̃v[
+*/
+struct Pool {
+	struct Job *jobs; /* Wu */
+	struct Worker *workers; /* [J */
+	int count; /* [J */
+};
+
+/*
+	pX}jtFXg̃fBNg̑΃pXƂĉ
+*/
+static char *resolvePath(char *buf, const char *dir, const char *path)
+{
+	if(*path == 0 || *path == '~')
+		return setHomeDir(buf, path);
+#ifdef _WIN32
+	if(*path == '/' || *path == '\\' || (path[0] != 0 && path[1] == ':'))
+#else
+	if(*path == '/')
+#endif
+		strcpy(buf, path);
+	else
+		sprintf(buf, "%s/%s", dir, path);
+	return buf;
+}
+
+/*
+	Wuɖ{̂̈ǉ (addSetting, finishJob̉)
+	arg: malloc (ǉłȂΉ)
+*/
+static int addArg(struct Job *job, char *arg)
+{
+	if(arg == NULL)
+		return FALSE;
+	if(job->argc >= JOB_SETTINGS + 1) {
+		free(arg);
+		return FALSE;
+	}
+	job->argv[job->argc++] = arg;
+	job->argv[job->argc] = NULL;
+	return TRUE;
+}
+
+/*
+	Wuɖ{̂̐ݒǉ (readManifest̉)
+*/
+static int addSetting(struct Job *job, const char *key, const char *value)
+{
+	char *p;
+
+	if(strlen(key) >= sizeof(((Conf *)0)->key) || strlen(value) >= sizeof(((Conf *)0)->value))
+		return FALSE;
+	if((p = malloc(strlen(key) + strlen(value) + 3)) == NULL)
+		return FALSE;
+	sprintf(p, "-%s=%s", key, value);
+	return addArg(job, p);
+}
+
+/*
+	Wu̖{̂̈
+*/
+static void freeArgs(struct Job *job)
+{
+	int i;
+
+	for(i = 1; i < job->argc; i++)
+		free(job->argv[i]);
+	job->argc = 1;
+	job->argv[1] = NULL;
+}
+
+/*
+	pXlƂ{̂̐ݒ肩? (setJob̉)
+*/
+static int isPathSetting(const char *key)
+{
+	const char *keys[] = { "sio_in", "sio_out", "printer", "floppy_dir", "floppy_image", "wave_path", "capture_path", NULL }, **p;
+
+	for(p = keys; *p != NULL; p++)
+		if(strcasecmp(key, *p) == 0)
+			return TRUE;
+	return FALSE;
+}
+
+/*
+	Wu̐ݒ1ݒ肷 (readManifest̉)
+*/
+static int setJob(struct Job *job, const char *dir, const char *key, const char *value)
+{
+	char path[PATH_MAX];
+
+	if(strcasecmp(key, "rom") == 0)
+		resolvePath(job->rom, dir, value);
+	else if(strcasecmp(key, "ram") == 0)
+		resolvePath(job->ram, dir, value);
+	else if(strcasecmp(key, "program") == 0)
+		resolvePath(job->program, dir, value);
+	else if(strcasecmp(key, "start") == 0)
+		job->start = (*value == 0 ? -1: (int )strtol(value, NULL, 16));
+	else if(strcasecmp(key, "input") == 0)
+		resolvePath(job->input, dir, value);
+	else if(strcasecmp(key, "input_wait") == 0)
+		job->input_wait = atoi(value);
+	else if(strcasecmp(key, "states") == 0)
+		job->states = strtoll(value, NULL, 10);
+	else if(strcasecmp(key, "expect_sio") == 0)
+		resolvePath(job->expect_sio, dir, value);
+	else if(strcasecmp(key, "expect_printer") == 0)
+		resolvePath(job->expect_printer, dir, value);
+	else if(strcasecmp(key, "expect_lcd") == 0) {
+		job->expect_lcd_valid = (*value != 0);
+		job->expect_lcd = strtoull(value, NULL, 16);
+	} else if(isPathSetting(key))
+		return addSetting(job, key, resolvePath(path, dir, value));
+	else
+		return addSetting(job, key, value);
+	return TRUE;
+}
+
+/*
+	{̂̐ݒ肪邩? (finishJob̉)
+*/
+static int hasSetting(const struct Job *job, const char *key)
+{
+	int i, len = strlen(key);
+
+	for(i = 1; i < job->argc; i++)
+		if(strncasecmp(job->argv[i] + 1, key, len) == 0 && job->argv[i][len + 1] == '=')
+			return TRUE;
+	return FALSE;
+}
+
+/*
+	Wu̐ݒI (readManifest̉)
+	}jtFXg̐擪̐ݒ̓Wu̐ݒɕׂ (Ɍݒ肪D悳)
+	jobs: Wu (ŌオݒIWu), dir: }jtFXĝfBNg
+*/
+static int finishJob(struct Job *jobs, int count, const struct Job *defaults, const char *dir)
+{
+	struct Job *job = &jobs[count - 1];
+	char name[sizeof(job->name)], *p;
+	int i;
+
+	for(i = 1; i < defaults->argc; i++)
+		if(!addArg(job, strdup(defaults->argv[i])))
+			return FALSE;
+
+	/* ƃfBNg̃t@CLȂ悤, w肪Ȃ΃VA͂͂ȂƂ */
+	if(!hasSetting(job, "sio_in") && !addSetting(job, "sio_in", ""))
+		return FALSE;
+
+	/* w肪Ȃ΃tbs[fBXN̓WuƂ̃fBNgƂ (O/擪._ɂ) */
+	if(!hasSetting(job, "floppy_dir")) {
+		strcpy(name, job->name);
+		for(p = name; *p != 0; p++)
+			if(!isalnum((unsigned char )*p) && *p != '-' && *p != '_' && (*p != '.' || p == name))
+				*p = '_';
+		if(snprintf(job->floppy_dir, sizeof(job->floppy_dir), "%s/%s", dir, name) >= (int )sizeof(job->floppy_dir))
+			return FALSE;
+		for(i = 0; i < count - 1; i++)
+			if(strcmp(jobs[i].floppy_dir, job->floppy_dir) == 0) {
+				fprintf(stderr, "JOB NAME CONFLICTS WITH %s. (%s)\n", jobs[i].name, job->name);
+				return FALSE;
+			}
+		if(!addSetting(job, "floppy_dir", job->floppy_dir))
+			return FALSE;
+	}
+
+	/* ͏oȂ */
+	return addSetting(job, "buzzer", "n");
+}
+
+/*
+	Wu
+*/
+static void freeJobs(struct Job *jobs, int count)
+{
+	int i;
+
+	for(i = 0; i < count; i++) {
+		freeArgs(&jobs[i]);
+		free(jobs[i].sio);
+		free(jobs[i].printer);
+	}
+	free(jobs);
+}
+
+/*
+	}jtFXgǂݍ
+	߂l: Wu̐ (G[Ȃ-1)
+*/
+static int readManifest(const char *path, struct Job **ret_jobs)
+{
+	FILE *fp;
+	struct Job defaults, *jobs = NULL, *job = &defaults, *p;
+	char dir[PATH_MAX], buf[MANIFEST_LINE], *key, *value, *q;
+	int count = 0, line = 0, i;
+
+	if((fp = fopen(path, "r")) == NULL) {
+		fprintf(stderr, "CANNOT OPEN MANIFEST. (%s)\n", path);
+		return -1;
+	}
+
+	/* }jtFXĝfBNg */
+	strcpy(dir, path);
+	if((q = strrchr(dir, '/')) == NULL)
+		q = strrchr(dir, '\\');
+	if(q != NULL)
+		*q = 0;
+	else
+		strcpy(dir, ".");
+
+	memset(&defaults, 0, sizeof(defaults));
+	defaults.start = -1;
+	defaults.states = JOB_STATES;
+	defaults.argv[defaults.argc++] = "z1f9-batch";
+
+	while(fgets(buf, sizeof(buf), fp) != NULL) {
+		line++;
+
+		/* ӂƉEӂɕ */
+		if((q = strchr(buf, '#')) != NULL)
+			*q = 0;
+		for(q = buf + strlen(buf); q > buf && (q[-1] == ' ' || q[-1] == '\t' || q[-1] == '\r' || q[-1] == '\n'); q--)
+			;
+		*q = 0;
+		for(key = buf; *key == ' ' || *key == '\t'; key++)
+			;
+		if(*key == 0)
+			continue;
+		for(value = key; *value != ' ' && *value != '\t' && *value != 0; value++)
+			;
+		if(*value != 0)
+			*value++ = 0;
+		for(; *value == ' ' || *value == '\t'; value++)
+			;
+
+		/* VWun߂ */
+		if(strcasecmp(key, "job") == 0) {
+			if(job != &defaults && !finishJob(jobs, count, &defaults, dir))
+				goto error;
+			if((p = realloc(jobs, sizeof(*jobs) * (count + 1))) == NULL)
+				goto error;
+			jobs = p;
+			job = &jobs[count++];
+			*job = defaults;
+			job->argc = 1;
+			job->argv[1] = NULL;
+
+			/* OȂΔԍƂ */
+			if(*value != 0)
+				snprintf(job->name, sizeof(job->name), "%s", value);
+			else
+				sprintf(job->name, "%d", count);
+			for(i = 0; i < count - 1; i++)
+				if(strcmp(jobs[i].name, job->name) == 0) {
+					fprintf(stderr, "DUPLICATE JOB NAME. (%s)\n", job->name);
+					goto error;
+				}
+			continue;
+		}
+
+		if(!setJob(job, dir, key, value))
+			goto error;
+	}
+	if(job != &defaults && !finishJob(jobs, count, &defaults, dir))
+		goto error;
+
+	fclose(fp);
+	freeArgs(&defaults);
+	*ret_jobs = jobs;
+	return count;
+
+error:;
+	fprintf(stderr, "ILLEGAL MANIFEST. (%s:%d)\n", path, line);
+	fclose(fp);
+	freeArgs(&defaults);
+	freeJobs(jobs, count);
+	return -1;
+}
+
+/*
+	t@C̓eǂݍ
+	߂l: e (ǂݍ߂ȂNULL, I[0t)
+*/
+static uint8 *readFile(const char *path, int *len)
+{
+	FILE *fp;
+	uint8 *buf = NULL, *p;
+	int size = 0, n;
+
+	if((fp = fopen(path, "rb")) == NULL)
+		return NULL;
+
+	*len = 0;
+	do {
+		if(*len + 1 >= size) {
+			size = (size == 0 ? 0x1000: size * 2);
+			if((p = realloc(buf, size)) == NULL) {
+				free(buf);
+				fclose(fp);
+				return NULL;
+			}
+			buf = p;
+		}
+		n = (int )fread(buf + *len, 1, size - *len - 1, fp);
+		*len += n;
+	} while(n > 0);
+	buf[*len] = 0;
+
+	fclose(fp);
+	return buf;
+}
+
+/*
+	o͂҂t@CƔׂ (runJob̉)
+*/
+static int compareOutput(const uint8 *out, int len, const char *path)
+{
+	uint8 *expect;
+	int expect_len, result;
+
+	if((expect = readFile(path, &expect_len)) == NULL)
+		return FALSE;
+	result = (expect_len == len && (len == 0 || memcmp(expect, out, len) == 0));
+	free(expect);
+	return result;
+}
+
+/*
+	LCD̃nbV𓾂 (FNV-1a 64bit, VRAMƃV{) (runJob̉)
+*/
+static uint64 hashLCD(Z1stat *z1)
+{
+	const uint8 *vram;
+	uint8 status;
+	uint64 hash = 0xcbf29ce484222325ULL;
+	int i;
+
+	vram = getZ1VRAM(z1, &status);
+	for(i = 0; i < (LCD_WIDTH / 8) * LCD_HEIGHT; i++)
+		hash = (hash ^ vram[i]) * 0x100000001b3ULL;
+	return (hash ^ status) * 0x100000001b3ULL;
+}
+
+/*
+	Wus (runJob̉)
+	߂l: sł?
+*/
+static int execJob(struct Job *job, Z1stat *z1)
+{
+	const uint8 *out;
+	uint8 *text, *p, *q;
+	int64 wait;
+	int len;
+
+	/* RAMEvOEROMǂݍ */
+	if(!loadZ1RAM(z1, (*job->ram != 0 ? job->ram: NULL)) && *job->ram != 0) {
+		sprintf(job->error, "CANNOT OPEN RAM IMAGE FILE. (%s)", job->ram);
+		return FALSE;
+	}
+	if(*job->program != 0 && !loadZ1Program(z1, job->program, job->start)) {
+		sprintf(job->error, "CANNOT OPEN FILE. (%s)", job->program);
+		return FALSE;
+	}
+	if(*job->rom == 0) {
+		if(z1->run.start < 0) {
+			sprintf(job->error, "NO ROM IMAGE.");
+			return FALSE;
+		}
+		loadZ1ROM(z1, NULL);
+	} else if(!loadZ1ROM(z1, job->rom)) {
+		sprintf(job->error, "CANNOT OPEN ROM IMAGE FILE. (%s)", job->rom);
+		return FALSE;
+	}
+	resetZ1(z1);
+
+	/* ͂ */
+	if(*job->input != 0) {
+		if((text = readFile(job->input, &len)) == NULL) {
+			sprintf(job->error, "CANNOT OPEN FILE. (%s)", job->input);
+			return FALSE;
+		}
+
+		/* sRETURNL[ɂ (CR͎̂Ă) */
+		for(p = q = text; *p != 0; p++)
+			if(*p == '\n')
+				*q++ = '\r';
+			else if(*p != '\r')
+				*q++ = *p;
+		*q = 0;
+
+		wait = MIN((int64 )job->input_wait * z1->setting.cpu_clock / 1000, job->states);
+		if(runZ1(z1, wait, Z1_EVENT_NONE) != Z1_EVENT_POWEROFF)
+			typeZ1Text(z1, (const char *)text);
+		free(text);
+	}
+
+	/* d؂邩܂Ŏs */
+	if(runZ1(z1, job->states - (int64 )getZ1States(z1), Z1_EVENT_NONE) == Z1_EVENT_POWEROFF)
+		job->off = TRUE;
+	job->executed = getZ1States(z1);
+	job->lcd = hashLCD(z1);
+
+	/* o͂ʂ */
+	out = getZ1Output(z1, Z1_OUTPUT_SIO, &len);
+	if((job->sio = malloc(len + 1)) != NULL) {
+		memcpy(job->sio, out, len);
+		job->sio_len = len;
+	}
+	out = getZ1Output(z1, Z1_OUTPUT_PRINTER, &len);
+	if((job->printer = malloc(len + 1)) != NULL) {
+		memcpy(job->printer, out, len);
+		job->printer_len = len;
+	}
+	return TRUE;
+}
+
+/*
+	WusĔ肷
+*/
+static void runJob(struct Job *job)
+{
+	Z1stat *z1;
+	int64 start = getClock();
+
+	if(*job->floppy_dir != 0 && mkdir(job->floppy_dir, 0777) < 0 && errno != EEXIST)
+		sprintf(job->error, "CANNOT CREATE DIRECTORY. (%s)", job->floppy_dir);
+	else if((z1 = createZ1(NULL, job->argc, job->argv)) == NULL)
+		sprintf(job->error, "CANNOT INITIALIZE.");
+	else {
+		keepZ1Output(z1, Z1_OUTPUT_SIO);
+		keepZ1Output(z1, Z1_OUTPUT_PRINTER);
+		execJob(job, z1);
+		destroyZ1(z1);
+	}
+	job->wall = getClock() - start;
+
+	/* ҂錋ʂƔׂ */
+	job->sio_ok = (*job->expect_sio == 0 || compareOutput(job->sio, job->sio_len, job->expect_sio));
+	job->printer_ok = (*job->expect_printer == 0 || compareOutput(job->printer, job->printer_len, job->expect_printer));
+	job->lcd_ok = (!job->expect_lcd_valid || job->lcd == job->expect_lcd);
+	job->pass = (*job->error == 0 && job->sio_ok && job->printer_ok && job->lcd_ok);
+
+	fprintf(stderr, "%s %s%s%s\n", job->pass ? "PASS": "FAIL", job->name, *job->error != 0 ? ": ": "", job->error);
+}
+
+/*
+	Wuo (̃L[̖, ȂΑ̃[J̐擪瓐) (workerLoop̉)
+	߂l: Wu̔ԍ (Ȃ-1)
+*/
+static int takeJob(struct Worker *w)
+{
+	struct Pool *pool = w->pool;
+	struct Worker *v;
+	int i, n = -1;
+
+	pthread_mutex_lock(&w->mutex);
+	if(w->bottom > w->top)
+		n = w->queue[--w->bottom];
+	pthread_mutex_unlock(&w->mutex);
+
+	for(i = 1; n < 0 && i < pool->count; i++) {
+		v = &pool->workers[(w->index + i) % pool->count];
+		pthread_mutex_lock(&v->mutex);
+		if(v->bottom > v->top)
+			n = v->queue[v->top++];
+		pthread_mutex_unlock(&v->mutex);
+	}
+	return n;
+}
+
+/*
+	[JXbh
+*/
+static void *workerLoop(void *arg)
+{
+	struct Worker *w = arg;
+	int n;
+
+	/* Wurő邱Ƃ͂Ȃ̂, ǂɂȂȂΏI */
+	while((n = takeJob(w)) >= 0)
+		runJob(&w->pool->jobs[n]);
+	return NULL;
+}
+
+/*
+	ׂẴWus
+*/
+static int runJobs(struct Job *jobs, int count, int threads)
+{
+	struct Pool pool;
+	struct Worker *w;
+	int started = 0, result = TRUE, i;
+
+	pool.jobs = jobs;
+	pool.count = MAX(MIN(threads, count), 1);
+	if((pool.workers = calloc(pool.count, sizeof(struct Worker))) == NULL)
+		return FALSE;
+
+	/* WuԂɔz */
+	for(i = 0; i < pool.count; i++) {
+		w = &pool.workers[i];
+		w->pool = &pool;
+		w->index = i;
+		if((w->queue = malloc(sizeof(int) * (count / pool.count + 1))) == NULL)
+			result = FALSE;
+		pthread_mutex_init(&w->mutex, NULL);
+	}
+	if(!result)
+		goto end;
+	for(i = count - 1; i >= 0; i--) {
+		w = &pool.workers[i % pool.count];
+		w->queue[w->bottom++] = i;
+	}
+
+	/* 쐬łȂ[J͑̃̕[JŎs */
+	for(i = 0; i < pool.count; i++)
+		if((pool.workers[i].started = (pthread_create(&pool.workers[i].thread, NULL, workerLoop, &pool.workers[i]) == 0)))
+			started++;
+		else
+			fprintf(stderr, "pthread_create fail.\n");
+	if(started == 0)
+		workerLoop(&pool.workers[0]);
+
+	/* ̃[Jmutexĝ, ׂďIĂj */
+	for(i = 0; i < pool.count; i++)
+		if(pool.workers[i].started)
+			pthread_join(pool.workers[i].thread, NULL);
+end:;
+	for(i = 0; i < pool.count; i++) {
+		pthread_mutex_destroy(&pool.workers[i].mutex);
+		free(pool.workers[i].queue);
+	}
+	free(pool.workers);
+	return result;
+}
+
+/*
+	JSON̕o͂
+	0x200x7fȏ̃oCg\u00XXɂ
+*/
+static void writeJSONString(FILE *fp, const uint8 *p, int len)
+{
+	int i;
+
+	fputc('"', fp);
+	for(i = 0; i < len; i++)
+		switch(p[i]) {
+		case '"':
+			fputs("\\\"", fp);
+			break;
+		case '\\':
+			fputs("\\\\", fp);
+			break;
+		case '\n':
+			fputs("\\n", fp);
+			break;
+		case '\r':
+			fputs("\\r", fp);
+			break;
+		case '\t':
+			fputs("\\t", fp);
+			break;
+		default:
+			if(p[i] < 0x20 || p[i] >= 0x7f)
+				fprintf(fp, "\\u%04x", p[i]);
+			else
+				fputc(p[i], fp);
+			break;
+		}
+	fputc('"', fp);
+}
+
+/*
+	ʂJSONŏo͂
+*/
+static void writeResult(FILE *fp, const struct Job *jobs, int count, int64 wall)
+{
+	const struct Job *job;
+	const char *sep;
+	int i, passed = 0;
+
+	fprintf(fp, "{\n\t\"jobs\": [\n");
+	for(i = 0; i < count; i++) {
+		job = &jobs[i];
+		passed += job->pass;
+
+		fprintf(fp, "\t\t{\n\t\t\t\"name\": ");
+		writeJSONString(fp, (const uint8 *)job->name, strlen(job->name));
+		fprintf(fp, ",\n\t\t\t\"pass\": %s,\n", job->pass ? "true": "false");
+		fprintf(fp, "\t\t\t\"error\": ");
+		if(*job->error != 0)
+			writeJSONString(fp, (const uint8 *)job->error, strlen(job->error));
+		else
+			fprintf(fp, "null");
+		fprintf(fp, ",\n\t\t\t\"states\": %llu,\n", (unsigned long long )job->executed);
+		fprintf(fp, "\t\t\t\"wall_ms\": %.3f,\n", job->wall / 1e6);
+		fprintf(fp, "\t\t\t\"power_off\": %s,\n", job->off ? "true": "false");
+		fprintf(fp, "\t\t\t\"sio\": ");
+		writeJSONString(fp, job->sio, job->sio_len);
+		fprintf(fp, ",\n\t\t\t\"printer\": ");
+		writeJSONString(fp, job->printer, job->printer_len);
+		fprintf(fp, ",\n\t\t\t\"lcd\": \"%016llx\",\n", (unsigned long long )job->lcd);
+		fprintf(fp, "\t\t\t\"mismatch\": [");
+		sep = "";
+		if(!job->sio_ok) {
+			fprintf(fp, "%s\"sio\"", sep);
+			sep = ", ";
+		}
+		if(!job->printer_ok) {
+			fprintf(fp, "%s\"printer\"", sep);
+			sep = ", ";
+		}
+		if(!job->lcd_ok)
+			fprintf(fp, "%s\"lcd\"", sep);
+		fprintf(fp, "]\n");
+		fprintf(fp, "\t\t}%s\n", i < count - 1 ? ",": "");
+	}
+	fprintf(fp, "\t],\n\t\"passed\": %d,\n\t\"failed\": %d,\n\t\"wall_ms\": %.3f\n}\n", passed, count - passed, wall / 1e6);
+}
+
+/*
+	CPU̐𓾂
+*/
+static int getCPUs(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+	return (int )info.dwNumberOfProcessors;
+#else
+	return (int )sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+	Conf conf[16];
+	struct Job *jobs;
+	FILE *fp = stdout;
+	const char *manifest = NULL, *output;
+	int64 start;
+	int count, threads, passed, i;
+
+	/* 𓾂 */
+	getConfig(conf, sizeof(conf) / sizeof(conf[0]), NULL, argc, argv);
+	threads = getOptInt(conf, "threads", getCPUs());
+	output = getOptText(conf, "output", "");
+	for(i = 1; i < argc; i++)
+		if(*argv[i] != '-')
+			manifest = argv[i];
+	if(manifest == NULL) {
+		fprintf(stderr, "usage: z1f9-batch [-threads=<N>] [-output=<file>] <manifest>\n");
+		return 2;
+	}
+
+	/* }jtFXgǂݍ */
+	if((count = readManifest(manifest, &jobs)) < 0)
+		return 2;
+
+	/* s */
+	start = getClock();
+	if(!runJobs(jobs, count, threads))
+		return 2;
+
+	/* ʂo͂ */
+	if(strcmp(output, "") != 0 && (fp = fopen(output, "w")) == NULL) {
+		fprintf(stderr, "CANNOT OPEN FILE. (%s)\n", output);
+		return 2;
+	}
+	writeResult(fp, jobs, count, getClock() - start);
+	if(fp != stdout)
+		fclose(fp);
+
+	for(passed = i = 0; i < count; i++)
+		passed += jobs[i].pass;
+	freeJobs(jobs, count);
+	return passed == count ? 0: 1;
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
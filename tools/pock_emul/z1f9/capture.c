@@ -0,0 +1,462 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	LCDLv`
+*/
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode)	_mkdir(path)
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include "z1.h"
+
+/* Lv`摜̑傫 (V{3hbg+Ԋu1hbg+LCD, ㉺1hbg̗]) */
+#define CAPTURE_WIDTH	(4 + LCD_WIDTH)
+#define CAPTURE_HEIGHT	(LCD_HEIGHT + 2)
+
+/* L[̒ */
+#define CAPTURE_QUEUE	64
+
+/* Lv`t[ */
+struct CaptureFrame {
+	uint64 states; /* o߃Xe[g */
+	uint8 vram[(LCD_WIDTH / 8) * LCD_HEIGHT]; /* VRAM */
+	uint8 status; /* V{KCh */
+};
+
+/* Lv`̏ */
+struct Capture {
+	struct CaptureFrame queue[CAPTURE_QUEUE]; /* ҂̃t[ */
+	int head, tail; /* L[̓ǏoʒuEʒu */
+	int quit; /* I邩? */
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	pthread_t thread;
+
+	int format; /* Lv`` */
+	char path[PATH_MAX]; /* o͐ */
+	FILE *fp_raw; /* raw̏o̓t@C */
+	int count; /* 񂾃t[ */
+	int captured; /* Lv`Ƃ邩? */
+	uint32 last_hash; /* ŌɃLv`t[̃nbVl */
+	int dropped; /* Ԃɍ킸̂Ăt[ */
+	int failed; /* ߂Ȃt[ */
+};
+
+/*
+	t[̃nbVl𓾂 (FNV-1a)
+*/
+static uint32 getFrameHash(const uint8 *vram, uint8 status)
+{
+	uint32 h = 2166136261U;
+	const uint8 *p;
+
+	for(p = vram; p < vram + (LCD_WIDTH / 8) * LCD_HEIGHT; p++)
+		h = (h ^ *p) * 16777619U;
+	return (h ^ status) * 16777619U;
+}
+
+/*
+	t[1rbg̉摜ɓWJ (1:_)
+*/
+static void getFrameBitmap(uint8 *bitmap, const struct CaptureFrame *f)
+{
+	static const uint8 mask[] = { 0x01, 0x04, 0x08, 0x10, 0x20, 0x80 };
+	int x, y, i;
+
+	memset(bitmap, 0, CAPTURE_WIDTH * CAPTURE_HEIGHT);
+	for(i = 0; i < 6; i++)
+		if(f->status & mask[i])
+			for(y = i * 6 + 1; y < i * 6 + 3; y++)
+				for(x = 0; x < 3; x++)
+					bitmap[y * CAPTURE_WIDTH + x] = 1;
+	for(y = 0; y < LCD_HEIGHT; y++)
+		for(x = 0; x < LCD_WIDTH; x++)
+			bitmap[(y + 1) * CAPTURE_WIDTH + 4 + x] = (f->vram[y * (LCD_WIDTH / 8) + x / 8] >> (7 - x % 8)) & 1;
+}
+
+/*
+	1rbg̉摜1sl߂ ()
+*/
+static int packBitmap(uint8 *packed, const uint8 *bitmap, int invert)
+{
+	int x, y, len = 0;
+
+	for(y = 0; y < CAPTURE_HEIGHT; y++)
+		for(x = 0; x < CAPTURE_WIDTH; x += 8) {
+			int i, b = 0;
+
+			for(i = 0; i < 8; i++)
+				if(x + i < CAPTURE_WIDTH && (bitmap[y * CAPTURE_WIDTH + x + i] ^ invert))
+					b |= 0x80 >> i;
+			packed[len++] = b;
+		}
+	return len;
+}
+
+/*
+	PBMŏ
+*/
+static void writePBM(FILE *fp, const uint8 *bitmap)
+{
+	uint8 packed[(CAPTURE_WIDTH + 7) / 8 * CAPTURE_HEIGHT];
+	int len;
+
+	len = packBitmap(packed, bitmap, 0);
+	fprintf(fp, "P4\n%d %d\n", CAPTURE_WIDTH, CAPTURE_HEIGHT);
+	fwrite(packed, 1, len, fp);
+}
+
+/*
+	PGMŏ
+*/
+static void writePGM(FILE *fp, const uint8 *bitmap)
+{
+	uint8 gray[CAPTURE_WIDTH * CAPTURE_HEIGHT];
+	int i;
+
+	for(i = 0; i < CAPTURE_WIDTH * CAPTURE_HEIGHT; i++)
+		gray[i] = bitmap[i] ? 0: 255;
+	fprintf(fp, "P5\n%d %d\n255\n", CAPTURE_WIDTH, CAPTURE_HEIGHT);
+	fwrite(gray, 1, sizeof(gray), fp);
+}
+
+/*
+	CRCXV (writePNG̉)
+*/
+static uint32 updateCRC(uint32 crc, const uint8 *p, int len)
+{
+	int i;
+
+	while(len-- > 0) {
+		crc ^= *p++;
+		for(i = 0; i < 8; i++)
+			crc = (crc & 1) ? 0xedb88320U ^ (crc >> 1): crc >> 1;
+	}
+	return crc;
+}
+
+/*
+	32rbgrbOGfBAŊi[ (writePNG̉)
+*/
+static uint8 *putBE32(uint8 *p, uint32 val)
+{
+	p[0] = val >> 24;
+	p[1] = val >> 16;
+	p[2] = val >> 8;
+	p[3] = val;
+	return p + 4;
+}
+
+/*
+	PNG̃`N (writePNG̉)
+*/
+static void writeChunk(FILE *fp, const char *type, const uint8 *data, int len)
+{
+	uint8 buf[4];
+	uint32 crc;
+
+	putBE32(buf, len);
+	fwrite(buf, 1, 4, fp);
+	fwrite(type, 1, 4, fp);
+	if(len > 0)
+		fwrite(data, 1, len, fp);
+	crc = updateCRC(0xffffffffU, (const uint8 *)type, 4);
+	crc = updateCRC(crc, data, len) ^ 0xffffffffU;
+	putBE32(buf, crc);
+	fwrite(buf, 1, 4, fp);
+}
+
+/*
+	PNGŏ (1rbgO[XP[, kdeflate)
+*/
+static void writePNG(FILE *fp, const uint8 *bitmap)
+{
+	uint8 packed[(CAPTURE_WIDTH + 7) / 8 * CAPTURE_HEIGHT];
+	uint8 ihdr[13], idat[2 + 5 + sizeof(packed) + CAPTURE_HEIGHT + 4], *p, *q;
+	uint32 a = 1, b = 0;
+	int row = (CAPTURE_WIDTH + 7) / 8, raw_len = (row + 1) * CAPTURE_HEIGHT, y, i;
+
+	packBitmap(packed, bitmap, 1);
+
+	/* IHDR */
+	putBE32(ihdr, CAPTURE_WIDTH);
+	putBE32(ihdr + 4, CAPTURE_HEIGHT);
+	ihdr[8] = 1; /* rbg[x */
+	ihdr[9] = 0; /* O[XP[ */
+	ihdr[10] = 0;
+	ihdr[11] = 0;
+	ihdr[12] = 0;
+
+	/* IDAT (zlib, kubN1) */
+	p = idat;
+	*p++ = 0x78;
+	*p++ = 0x01;
+	*p++ = 0x01;
+	*p++ = raw_len & 0xff;
+	*p++ = raw_len >> 8;
+	*p++ = ~raw_len & 0xff;
+	*p++ = (~raw_len >> 8) & 0xff;
+	for(y = 0; y < CAPTURE_HEIGHT; y++) {
+		q = p;
+		*p++ = 0; /* tB^Ȃ */
+		memcpy(p, &packed[y * row], row);
+		p += row;
+		for(i = 0; i < row + 1; i++) {
+			a = (a + q[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+	}
+	p = putBE32(p, (b << 16) | a);
+
+	fwrite("\x89PNG\r\n\x1a\n", 1, 8, fp);
+	writeChunk(fp, "IHDR", ihdr, sizeof(ihdr));
+	writeChunk(fp, "IDAT", idat, p - idat);
+	writeChunk(fp, "IEND", NULL, 0);
+}
+
+/*
+	rawŏ (o߃Xe[g8oCg(gGfBA)+VRAM+V{)
+*/
+static void writeRaw(FILE *fp, const struct CaptureFrame *f)
+{
+	uint8 states[8];
+	int i;
+
+	for(i = 0; i < 8; i++)
+		states[i] = (f->states >> (i * 8)) & 0xff;
+	fwrite(states, 1, sizeof(states), fp);
+	fwrite(f->vram, 1, sizeof(f->vram), fp);
+	fwrite(&f->status, 1, 1, fp);
+}
+
+/*
+	t[ (captureLoop̉)
+*/
+static void writeFrame(struct Capture *c, const struct CaptureFrame *f)
+{
+	static const char *ext[] = { "", "pbm", "pgm", "png" };
+	uint8 bitmap[CAPTURE_WIDTH * CAPTURE_HEIGHT];
+	char file[PATH_MAX + 16];
+	FILE *fp;
+
+	if(c->format == CAPTURE_RAW) {
+		if(c->fp_raw != NULL)
+			writeRaw(c->fp_raw, f);
+		return;
+	}
+
+	sprintf(file, "%s%06d.%s", c->path, c->count++, ext[c->format]);
+	if((fp = fopen(file, "wb")) == NULL) {
+		if(c->failed++ == 0)
+			fprintf(stderr, "CANNOT OPEN CAPTURE FILE. (%s)\n", file);
+		return;
+	}
+	getFrameBitmap(bitmap, f);
+	switch(c->format) {
+	case CAPTURE_PBM:
+		writePBM(fp, bitmap);
+		break;
+	case CAPTURE_PGM:
+		writePGM(fp, bitmap);
+		break;
+	case CAPTURE_PNG:
+		writePNG(fp, bitmap);
+		break;
+	}
+	fclose(fp);
+}
+
+/*
+	Xbh
+*/
+static void *captureLoop(void *arg)
+{
+	struct Capture *c = arg;
+	struct CaptureFrame f;
+
+	pthread_mutex_lock(&c->mutex);
+	for(;;) {
+		while(c->head == c->tail && !c->quit)
+			pthread_cond_wait(&c->cond, &c->mutex);
+		if(c->head == c->tail)
+			break;
+
+		/* ̓bNO */
+		f = c->queue[c->head];
+		c->head = (c->head + 1) % CAPTURE_QUEUE;
+		pthread_mutex_unlock(&c->mutex);
+		writeFrame(c, &f);
+		pthread_mutex_lock(&c->mutex);
+	}
+	pthread_mutex_unlock(&c->mutex);
+
+	if(c->fp_raw != NULL)
+		fflush(c->fp_raw);
+	return NULL;
+}
+
+/*
+	LCDLv`
+*/
+void captureLCD(Z1stat *z1)
+{
+	struct Capture *c = z1->capture;
+	uint32 hash;
+	int next;
+
+	if(c == NULL)
+		return;
+
+	/* ωȂΉȂ */
+	hash = getFrameHash(z1->vram.vram, z1->vram.status);
+	if(c->captured && hash == c->last_hash)
+		return;
+
+	/* L[ςȂΎ̂Ă */
+	pthread_mutex_lock(&c->mutex);
+	if((next = (c->tail + 1) % CAPTURE_QUEUE) == c->head) {
+		pthread_mutex_unlock(&c->mutex);
+		c->dropped++;
+		return;
+	}
+	c->queue[c->tail].states = z1->elapsed_states;
+	memcpy(c->queue[c->tail].vram, z1->vram.vram, sizeof(c->queue[c->tail].vram));
+	c->queue[c->tail].status = z1->vram.status;
+	c->tail = next;
+	c->captured = TRUE;
+	c->last_hash = hash;
+	pthread_cond_signal(&c->cond);
+	pthread_mutex_unlock(&c->mutex);
+}
+
+/*
+	Lv`I
+*/
+void stopCapture(Z1stat *z1)
+{
+	struct Capture *c = z1->capture;
+
+	if(c == NULL)
+		return;
+
+	pthread_mutex_lock(&c->mutex);
+	c->quit = TRUE;
+	pthread_cond_signal(&c->cond);
+	pthread_mutex_unlock(&c->mutex);
+	pthread_join(c->thread, NULL);
+
+	if(c->fp_raw != NULL)
+		fclose(c->fp_raw);
+	if(c->dropped > 0)
+		fprintf(stderr, "capture: %d frames dropped.\n", c->dropped);
+	if(c->failed > 0)
+		fprintf(stderr, "capture: %d frames not written.\n", c->failed);
+	pthread_mutex_destroy(&c->mutex);
+	pthread_cond_destroy(&c->cond);
+	free(c);
+	z1->capture = NULL;
+}
+
+/*
+	o͐̃fBNgȂ΍쐬 (initCapturẻ)
+*/
+static int makeParentDir(const char *path)
+{
+	char dir[PATH_MAX], *p, c;
+	struct stat st;
+
+	strcpy(dir, path);
+	for(p = dir + strlen(dir); p > dir && p[-1] != '/' && p[-1] != '\\'; p--)
+		;
+	if(p <= dir + 1)
+		return TRUE;
+	p[-1] = 0;
+
+	/* ォ珇ɍ쐬 (ɂƂ̎s͖čŌɊm߂) */
+	for(p = dir + 1; ; p++) {
+		if(*p != '/' && *p != '\\' && *p != 0)
+			continue;
+		c = *p;
+		*p = 0;
+		mkdir(dir, 0777);
+		if((*p = c) == 0)
+			break;
+	}
+	return stat(dir, &st) == 0 && (st.st_mode & S_IFDIR);
+}
+
+/*
+	Lv`
+*/
+int initCapture(Z1stat *z1)
+{
+	struct Capture *c;
+	char file[PATH_MAX + 16];
+
+	if(z1->setting.capture_format == CAPTURE_NONE)
+		return TRUE;
+	if((c = calloc(1, sizeof(*c))) == NULL)
+		return FALSE;
+	c->format = z1->setting.capture_format;
+	strcpy(c->path, z1->setting.path_capture);
+
+	if(!makeParentDir(c->path)) {
+		fprintf(stderr, "CANNOT OPEN CAPTURE FILE. (%s)\n", c->path);
+		free(c);
+		return FALSE;
+	}
+
+	if(c->format == CAPTURE_RAW) {
+		sprintf(file, "%s.raw", c->path);
+		if((c->fp_raw = fopen(file, "ab")) == NULL) {
+			fprintf(stderr, "CANNOT OPEN CAPTURE FILE. (%s)\n", file);
+			free(c);
+			return FALSE;
+		}
+	}
+
+	pthread_mutex_init(&c->mutex, NULL);
+	pthread_cond_init(&c->cond, NULL);
+	if(pthread_create(&c->thread, NULL, captureLoop, c) != 0) {
+		fprintf(stderr, "pthread_create fail.\n");
+		if(c->fp_raw != NULL)
+			fclose(c->fp_raw);
+		free(c);
+		return FALSE;
+	}
+	z1->capture = c;
+	return TRUE;
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
@@ -0,0 +1,137 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	Ƒ҂
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#endif
+#include <time.h>
+#include "z1.h"
+
+/* ߂x̏(imb) */
+#define DELAY_MAX_LAG	100000000LL
+
+/* ̊ */
+static int64 delayBase = -1; /* ̎(imb) */
+static int64 delayCount = 0; /* 琔̐ */
+static int delayRate = 0; /* (Hz) */
+
+/*
+	P鎞imbPʂœ
+*/
+int64 getClock(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq, count;
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (int64 )((double )count.QuadPart * 1e9 / freq.QuadPart);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64 )ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/*
+	w肵܂Ŗ (delay, sleepMs̉)
+*/
+static void sleepUntil(int64 t)
+{
+#ifdef _WIN32
+	int64 now = getClock();
+
+	if(t > now)
+		Sleep((DWORD )((t - now + 999999) / 1000000));
+#elif defined(TIMER_ABSTIME)
+	struct timespec ts;
+
+	ts.tv_sec = t / 1000000000;
+	ts.tv_nsec = t % 1000000000;
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+#else
+	struct timespec ts;
+	int64 now = getClock();
+
+	if(t <= now)
+		return;
+	ts.tv_sec = (t - now) / 1000000000;
+	ts.tv_nsec = (t - now) % 1000000000;
+	while(nanosleep(&ts, &ts) < 0 && errno == EINTR)
+		;
+#endif
+}
+
+/*
+	1/rateb̎ɍ킹đ҂
+*/
+void delay(int rate)
+{
+	int64 now = getClock(), deadline;
+
+	if(rate != delayRate || delayBase < 0) {
+		delayBase = now;
+		delayCount = 0;
+		delayRate = rate;
+	}
+
+	/* ̎̐Ŋ߂̂Œ[ςȂ */
+	deadline = delayBase + ++delayCount * 1000000000 / rate;
+
+	/* 傫xꂽƂ͎߂Ɋ߂ */
+	if(now - deadline > DELAY_MAX_LAG) {
+		delayBase = now;
+		delayCount = 0;
+		return;
+	}
+	sleepUntil(deadline);
+}
+
+/*
+	P鎞~bPʂœ
+*/
+uint32 getTicks(void)
+{
+	return (uint32 )(getClock() / 1000000);
+}
+
+/*
+	w肵~b
+*/
+void sleepMs(int ms)
+{
+	sleepUntil(getClock() + (int64 )ms * 1000000);
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
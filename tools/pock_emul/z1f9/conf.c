@@ -15,9 +15,6 @@
 #define FALSE	0
 #define TRUE	1
 
-/* ݒt@CUTF-8BOM邩? */
-static int isUtf8;
-
 /* Rg */
 #define COMMENT	'#'
 
@@ -30,14 +27,14 @@ const static OptTable tableYesNo[] = {
 	{ NULL, 0 }
 };
 
-/* z[fBNg (win32̂) */
+/* z[fBNg (win32̂, Xbh) */
 #ifdef _WIN32
-static char homeDir[PATH_MAX] = "";
+static __thread char homeDir[PATH_MAX] = "";
 #endif
 
-/* ėpobt@ (win32̂) */
+/* ėpobt@ (win32̂, Xbh) */
 #ifdef _WIN32
-static char _buffer[PATH_MAX];
+static __thread char _buffer[PATH_MAX];
 #endif
 
 /*
@@ -132,7 +129,7 @@ static int readArg(Conf *conf, char *argv)
 	memcpy(conf->key, argv + 1, size);
 	*(conf->key + size) = '\0';
 
-	size = (int )(q - p + 1);
+	size = (int )(q - p - 1);
 	memcpy(conf->value, p + 1, size);
 	*(conf->value + size) = '\0';
 
@@ -153,8 +150,6 @@ static FILE *openConfig(const char *file)
 	wchar_t wpath[PATH_MAX], wmode[4];
 #endif
 
-	isUtf8 = FALSE;
-
 #ifdef _WIN32
 	dir[0] = getenv("USERPROFILE");
 	dir[1] = getexedir();
@@ -189,14 +184,14 @@ static FILE *openConfig(const char *file)
 /*
 	t@CIvV𓾂 ()
 */
-static int readConfig(FILE *fp, Conf *conf)
+static int readConfig(FILE *fp, Conf *conf, int *utf8)
 {
 	char buf[160], *p, *q;
 
 	/* 1sǂݍ */
 	fgets(buf, sizeof(buf), fp);
 	if(memcmp(buf, "\xef\xbb\xbf", 3) == 0) {
-		isUtf8 = TRUE;
+		*utf8 = TRUE;
 		memmove(buf, buf + 3, strlen(buf + 3) + 1);
 	}
 
@@ -222,7 +217,7 @@ static int readConfig(FILE *fp, Conf *conf)
 
 	/* l */
 #ifdef _WIN32
-	if(isUtf8)
+	if(*utf8)
 		strcpy(conf->value, p);
 	else {
 		wchar_t wbuf[160];
@@ -245,7 +240,7 @@ Conf *getConfig(Conf *conf, int length, const char *file, int argc, char *argv[]
 {
 	Conf *p = conf, *last = conf + length - 1;
 	FILE *fp;
-	int i, line;
+	int i, line, utf8 = FALSE;
 
 	strcpy(p->key, "");
 	
@@ -257,11 +252,13 @@ Conf *getConfig(Conf *conf, int length, const char *file, int argc, char *argv[]
 		line++;
 	}
 
-	/* t@CIvV𓾂 */
+	/* t@CIvV𓾂 (t@CNULLȂΈg) */
+	if(file == NULL)
+		return conf;
 	if((fp = openConfig(file)) != NULL) {
 		line = 1;
 		while(!feof(fp) && p < last) {
-			if(readConfig(fp, p))
+			if(readConfig(fp, p, &utf8))
 				(p++)->line = line;
 			line++;
 		}
@@ -12,7 +12,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
-#include "z1.h"
+#define DEF_GLOBAL
+#include "depend.h"
 #include "caps1.xbm"
 #include "s1.xbm"
 #include "basic1.xbm"
@@ -40,6 +41,22 @@ static const SDL_VideoInfo *video;
 #endif
 #if SDL_MAJOR_VERSION == 2
 static SDL_Window *window;
+static SDL_Renderer *renderer = NULL;
+static SDL_Texture *texBack, *texPanel;
+static Uint32 texPixels[34 * 196];
+
+/* `Xbhɓnt[ */
+static struct Frame {
+	uint8 vram[(LCD_WIDTH / 8) * LCD_HEIGHT]; /* VRAM */
+	uint8 status; /* V{KCh */
+	uint32 seq; /* t[ԍ */
+} frames[3];
+#define FRAME_FRESH	0x04	/* \̃t[? */
+static int frameBack, frameFront; /* E\̃t[ */
+static SDL_atomic_t frameMiddle; /* 󂯓ñt[ */
+static SDL_Thread *renderThread = NULL;
+static SDL_sem *renderSem, *renderReady;
+static SDL_atomic_t renderQuit;
 #endif
 static SDL_Surface *screen;
 static SDL_Joystick *joy = NULL;
@@ -62,6 +79,18 @@ static SDL_Rect rectSymbol[] = {
 };
 static SDL_Rect rectPanel = { 10, 0, 196, 34 };
 static SDL_Rect rectLCD = { 14, 1, LCD_WIDTH, LCD_HEIGHT };
+#if SDL_MAJOR_VERSION == 2
+static SDL_Rect rectTexPanel = { 0, 0, 196, 34 };
+static SDL_Rect rectTexLCD = { 4, 1, LCD_WIDTH, LCD_HEIGHT };
+static SDL_Rect rectTexSymbol[] = {
+	{ 0, 1, 3, 2 },
+	{ 0, 7, 3, 2 },
+	{ 0, 13, 3, 2 },
+	{ 0, 19, 3, 2 },
+	{ 0, 25, 3, 2 },
+	{ 0, 31, 3, 2 }
+};
+#endif
 
 static unsigned char *caps_bits[] = { caps1_bits, caps2_bits, caps3_bits };
 static unsigned char *s_bits[] = { s1_bits, s2_bits, s3_bits };
@@ -74,6 +103,478 @@ static unsigned char *dot_bits[] = { dot1_bits, dot2_bits, dot3_bits };
 static const char *machineName;
 static int zoom;
 
+/* ΉtL[ */
+static OptTable tableKey[512] = {
+	{ "none", 0 },
+	{ "backspace", KEY_BACKSPACE },
+	{ "tab", KEY_TAB },
+	{ "clear", KEY_CLEAR },
+	{ "return", KEY_RETURN },
+	{ "enter", KEY_RETURN },
+	{ "pause", KEY_PAUSE },
+	{ "escape", KEY_ESCAPE },
+	{ "space", KEY_SPACE },
+	{ ":", KEY_COLON },
+	{ ",", KEY_COMMA },
+	{ "-", KEY_MINUS },
+	{ ".", KEY_PERIOD },
+	{ "/", KEY_SLASH },
+	{ "0", KEY_0 },
+	{ "1", KEY_1 },
+	{ "2", KEY_2 },
+	{ "3", KEY_3 },
+	{ "4", KEY_4 },
+	{ "5", KEY_5 },
+	{ "6", KEY_6 },
+	{ "7", KEY_7 },
+	{ "8", KEY_8 },
+	{ "9", KEY_9 },
+	{ ";", KEY_SEMICOLON },
+	{ "^", KEY_HAT },
+	{ "@", KEY_AT },
+	{ "]", KEY_RIGHTBRACKET },
+	{ "[", KEY_LEFTBRACKET },
+	{ "`", KEY_BACKQUOTE },
+	{ "a", KEY_A },
+	{ "b", KEY_B },
+	{ "c", KEY_C },
+	{ "d", KEY_D },
+	{ "e", KEY_E },
+	{ "f", KEY_F },
+	{ "g", KEY_G },
+	{ "h", KEY_H },
+	{ "i", KEY_I },
+	{ "j", KEY_J },
+	{ "k", KEY_K },
+	{ "l", KEY_L },
+	{ "m", KEY_M },
+	{ "n", KEY_N },
+	{ "o", KEY_O },
+	{ "p", KEY_P },
+	{ "q", KEY_Q },
+	{ "r", KEY_R },
+	{ "s", KEY_S },
+	{ "t", KEY_T },
+	{ "u", KEY_U },
+	{ "v", KEY_V },
+	{ "w", KEY_W },
+	{ "x", KEY_X },
+	{ "y", KEY_Y },
+	{ "z", KEY_Z },
+	{ "delete", KEY_DELETE },
+	{ "n0", KEY_KP0 },
+	{ "n1", KEY_KP1 },
+	{ "n2", KEY_KP2 },
+	{ "n3", KEY_KP3 },
+	{ "n4", KEY_KP4 },
+	{ "n5", KEY_KP5 },
+	{ "n6", KEY_KP6 },
+	{ "n7", KEY_KP7 },
+	{ "n8", KEY_KP8 },
+	{ "n9", KEY_KP9 },
+	{ "n.", KEY_KP_PERIOD },
+	{ "n/", KEY_KP_DIVIDE },
+	{ "n*", KEY_KP_MULTIPLY },
+	{ "n-", KEY_KP_MINUS },
+	{ "n+", KEY_KP_PLUS },
+	{ "nreturn", KEY_KP_ENTER },
+	{ "nenter", KEY_KP_ENTER },
+	{ "n=", KEY_KP_EQUALS },
+	{ "up", KEY_UP },
+	{ "down", KEY_DOWN },
+	{ "right", KEY_RIGHT },
+	{ "left", KEY_LEFT },
+	{ "insert", KEY_INSERT },
+	{ "home", KEY_HOME },
+	{ "end", KEY_END },
+	{ "pageup", KEY_PAGEUP },
+	{ "pagedown", KEY_PAGEDOWN  },
+	{ "f1", KEY_F1 },
+	{ "f2", KEY_F2 },
+	{ "f3", KEY_F3 },
+	{ "f4", KEY_F4 },
+	{ "f5", KEY_F5 },
+	{ "f6", KEY_F6 },
+	{ "f7", KEY_F7 },
+	{ "f8", KEY_F8 },
+	{ "f9", KEY_F9 },
+	{ "f10", KEY_F10 },
+	{ "f11", KEY_F11 },
+	{ "f12", KEY_F12 },
+	{ "f13", KEY_F13 },
+	{ "f14", KEY_F14 },
+	{ "f15", KEY_F15 },
+	{ "numlock", KEY_NUMLOCK },
+	{ "capslock", KEY_CAPSLOCK },
+	{ "scrolllock", KEY_SCROLLOCK },
+	{ "rshift", KEY_RSHIFT },
+	{ "lshift", KEY_LSHIFT },
+	{ "rctrl", KEY_RCTRL },
+	{ "lctrl", KEY_LCTRL },
+	{ "ralt", KEY_RALT },
+	{ "lalt", KEY_LALT },
+	{ "mode", KEY_MODE },
+	{ "compose", KEY_COMPOSE },
+	{ "help", KEY_HELP },
+	{ "print", KEY_PRINT },
+	{ "sysreq", KEY_SYSREQ },
+	{ "break", KEY_BREAK },
+	{ "menu", KEY_MENU },
+	{ "power", KEY_POWER },
+	{ "_", KEY_UNDERSCORE },
+	{ "kana", KEY_KANA },
+	{ "\\", KEY_YEN  },
+	{ "xfer", KEY_XFER },
+	{ "nfer", KEY_NFER },
+	{ "non-us-backslash", KEY_NONUSBACKSLASH },
+	{ "%backspace", KEYMOD_ALT | KEY_BACKSPACE },
+	{ "%tab", KEYMOD_ALT | KEY_TAB },
+	{ "%clear", KEYMOD_ALT | KEY_CLEAR },
+	{ "%return", KEYMOD_ALT | KEY_RETURN },
+	{ "%enter", KEYMOD_ALT | KEY_RETURN },
+	{ "%pause", KEYMOD_ALT | KEY_PAUSE },
+	{ "%escape", KEYMOD_ALT | KEY_ESCAPE },
+	{ "%space", KEYMOD_ALT | KEY_SPACE },
+	{ "%:", KEYMOD_ALT | KEY_COLON },
+	{ "%,", KEYMOD_ALT | KEY_COMMA },
+	{ "%-", KEYMOD_ALT | KEY_MINUS },
+	{ "%.", KEYMOD_ALT | KEY_PERIOD },
+	{ "%/", KEYMOD_ALT | KEY_SLASH },
+	{ "%0", KEYMOD_ALT | KEY_0 },
+	{ "%1", KEYMOD_ALT | KEY_1 },
+	{ "%2", KEYMOD_ALT | KEY_2 },
+	{ "%3", KEYMOD_ALT | KEY_3 },
+	{ "%4", KEYMOD_ALT | KEY_4 },
+	{ "%5", KEYMOD_ALT | KEY_5 },
+	{ "%6", KEYMOD_ALT | KEY_6 },
+	{ "%7", KEYMOD_ALT | KEY_7 },
+	{ "%8", KEYMOD_ALT | KEY_8 },
+	{ "%9", KEYMOD_ALT | KEY_9 },
+	{ "%;", KEYMOD_ALT | KEY_SEMICOLON },
+	{ "%^", KEYMOD_ALT | KEY_HAT },
+	{ "%@", KEYMOD_ALT | KEY_AT },
+	{ "%]", KEYMOD_ALT | KEY_RIGHTBRACKET },
+	{ "%[", KEYMOD_ALT | KEY_LEFTBRACKET },
+	{ "%`", KEYMOD_ALT | KEY_BACKQUOTE },
+	{ "%a", KEYMOD_ALT | KEY_A },
+	{ "%b", KEYMOD_ALT | KEY_B },
+	{ "%c", KEYMOD_ALT | KEY_C },
+	{ "%d", KEYMOD_ALT | KEY_D },
+	{ "%e", KEYMOD_ALT | KEY_E },
+	{ "%f", KEYMOD_ALT | KEY_F },
+	{ "%g", KEYMOD_ALT | KEY_G },
+	{ "%h", KEYMOD_ALT | KEY_H },
+	{ "%i", KEYMOD_ALT | KEY_I },
+	{ "%j", KEYMOD_ALT | KEY_J },
+	{ "%k", KEYMOD_ALT | KEY_K },
+	{ "%l", KEYMOD_ALT | KEY_L },
+	{ "%m", KEYMOD_ALT | KEY_M },
+	{ "%n", KEYMOD_ALT | KEY_N },
+	{ "%o", KEYMOD_ALT | KEY_O },
+	{ "%p", KEYMOD_ALT | KEY_P },
+	{ "%q", KEYMOD_ALT | KEY_Q },
+	{ "%r", KEYMOD_ALT | KEY_R },
+	{ "%s", KEYMOD_ALT | KEY_S },
+	{ "%t", KEYMOD_ALT | KEY_T },
+	{ "%u", KEYMOD_ALT | KEY_U },
+	{ "%v", KEYMOD_ALT | KEY_V },
+	{ "%w", KEYMOD_ALT | KEY_W },
+	{ "%x", KEYMOD_ALT | KEY_X },
+	{ "%y", KEYMOD_ALT | KEY_Y },
+	{ "%z", KEYMOD_ALT | KEY_Z },
+	{ "%delete", KEYMOD_ALT | KEY_DELETE },
+	{ "%n0", KEYMOD_ALT | KEY_KP0 },
+	{ "%n1", KEYMOD_ALT | KEY_KP1 },
+	{ "%n2", KEYMOD_ALT | KEY_KP2 },
+	{ "%n3", KEYMOD_ALT | KEY_KP3 },
+	{ "%n4", KEYMOD_ALT | KEY_KP4 },
+	{ "%n5", KEYMOD_ALT | KEY_KP5 },
+	{ "%n6", KEYMOD_ALT | KEY_KP6 },
+	{ "%n7", KEYMOD_ALT | KEY_KP7 },
+	{ "%n8", KEYMOD_ALT | KEY_KP8 },
+	{ "%n9", KEYMOD_ALT | KEY_KP9 },
+	{ "%n.", KEYMOD_ALT | KEY_KP_PERIOD },
+	{ "%n/", KEYMOD_ALT | KEY_KP_DIVIDE },
+	{ "%n*", KEYMOD_ALT | KEY_KP_MULTIPLY },
+	{ "%n-", KEYMOD_ALT | KEY_KP_MINUS },
+	{ "%n+", KEYMOD_ALT | KEY_KP_PLUS },
+	{ "%nreturn", KEYMOD_ALT | KEY_KP_ENTER },
+	{ "%nenter", KEYMOD_ALT | KEY_KP_ENTER },
+	{ "%n=", KEYMOD_ALT | KEY_KP_EQUALS },
+	{ "%up", KEYMOD_ALT | KEY_UP },
+	{ "%down", KEYMOD_ALT | KEY_DOWN },
+	{ "%right", KEYMOD_ALT | KEY_RIGHT },
+	{ "%left", KEYMOD_ALT | KEY_LEFT },
+	{ "%insert", KEYMOD_ALT | KEY_INSERT },
+	{ "%home", KEYMOD_ALT | KEY_HOME },
+	{ "%end", KEYMOD_ALT | KEY_END },
+	{ "%pageup", KEYMOD_ALT | KEY_PAGEUP },
+	{ "%pagedown", KEYMOD_ALT | KEY_PAGEDOWN  },
+	{ "%f1", KEYMOD_ALT | KEY_F1 },
+	{ "%f2", KEYMOD_ALT | KEY_F2 },
+	{ "%f3", KEYMOD_ALT | KEY_F3 },
+	{ "%f4", KEYMOD_ALT | KEY_F4 },
+	{ "%f5", KEYMOD_ALT | KEY_F5 },
+	{ "%f6", KEYMOD_ALT | KEY_F6 },
+	{ "%f7", KEYMOD_ALT | KEY_F7 },
+	{ "%f8", KEYMOD_ALT | KEY_F8 },
+	{ "%f9", KEYMOD_ALT | KEY_F9 },
+	{ "%f10", KEYMOD_ALT | KEY_F10 },
+	{ "%f11", KEYMOD_ALT | KEY_F11 },
+	{ "%f12", KEYMOD_ALT | KEY_F12 },
+	{ "%f13", KEYMOD_ALT | KEY_F13 },
+	{ "%f14", KEYMOD_ALT | KEY_F14 },
+	{ "%f15", KEYMOD_ALT | KEY_F15 },
+	{ "%numlock", KEYMOD_ALT | KEY_NUMLOCK },
+	{ "%capslock", KEYMOD_ALT | KEY_CAPSLOCK },
+	{ "%scrolllock", KEYMOD_ALT | KEY_SCROLLOCK },
+	{ "%mode", KEYMOD_ALT | KEY_MODE },
+	{ "%compose", KEYMOD_ALT | KEY_COMPOSE },
+	{ "%help", KEYMOD_ALT | KEY_HELP },
+	{ "%print", KEYMOD_ALT | KEY_PRINT },
+	{ "%sysreq", KEYMOD_ALT | KEY_SYSREQ },
+	{ "%break", KEYMOD_ALT | KEY_BREAK },
+	{ "%menu", KEYMOD_ALT | KEY_MENU },
+	{ "%power", KEYMOD_ALT | KEY_POWER },
+	{ "%_", KEYMOD_ALT | KEY_UNDERSCORE },
+	{ "%kana", KEYMOD_ALT | KEY_KANA },
+	{ "%\\", KEYMOD_ALT | KEY_YEN  },
+	{ "%xfer", KEYMOD_ALT | KEY_XFER },
+	{ "%nfer", KEYMOD_ALT | KEY_NFER },
+	{ "%non-us-backslash", KEYMOD_ALT | KEY_NONUSBACKSLASH },
+	{ "^backspace", KEYMOD_CTRL | KEY_BACKSPACE },
+	{ "^tab", KEYMOD_CTRL | KEY_TAB },
+	{ "^clear", KEYMOD_CTRL | KEY_CLEAR },
+	{ "^return", KEYMOD_CTRL | KEY_RETURN },
+	{ "^enter", KEYMOD_CTRL | KEY_RETURN },
+	{ "^pause", KEYMOD_CTRL | KEY_PAUSE },
+	{ "^escape", KEYMOD_CTRL | KEY_ESCAPE },
+	{ "^space", KEYMOD_CTRL | KEY_SPACE },
+	{ "^:", KEYMOD_CTRL | KEY_COLON },
+	{ "^,", KEYMOD_CTRL | KEY_COMMA },
+	{ "^-", KEYMOD_CTRL | KEY_MINUS },
+	{ "^.", KEYMOD_CTRL | KEY_PERIOD },
+	{ "^/", KEYMOD_CTRL | KEY_SLASH },
+	{ "^0", KEYMOD_CTRL | KEY_0 },
+	{ "^1", KEYMOD_CTRL | KEY_1 },
+	{ "^2", KEYMOD_CTRL | KEY_2 },
+	{ "^3", KEYMOD_CTRL | KEY_3 },
+	{ "^4", KEYMOD_CTRL | KEY_4 },
+	{ "^5", KEYMOD_CTRL | KEY_5 },
+	{ "^6", KEYMOD_CTRL | KEY_6 },
+	{ "^7", KEYMOD_CTRL | KEY_7 },
+	{ "^8", KEYMOD_CTRL | KEY_8 },
+	{ "^9", KEYMOD_CTRL | KEY_9 },
+	{ "^;", KEYMOD_CTRL | KEY_SEMICOLON },
+	{ "^^", KEYMOD_CTRL | KEY_HAT },
+	{ "^@", KEYMOD_CTRL | KEY_AT },
+	{ "^]", KEYMOD_CTRL | KEY_RIGHTBRACKET },
+	{ "^[", KEYMOD_CTRL | KEY_LEFTBRACKET },
+	{ "^`", KEYMOD_CTRL | KEY_BACKQUOTE },
+	{ "^a", KEYMOD_CTRL | KEY_A },
+	{ "^b", KEYMOD_CTRL | KEY_B },
+	{ "^c", KEYMOD_CTRL | KEY_C },
+	{ "^d", KEYMOD_CTRL | KEY_D },
+	{ "^e", KEYMOD_CTRL | KEY_E },
+	{ "^f", KEYMOD_CTRL | KEY_F },
+	{ "^g", KEYMOD_CTRL | KEY_G },
+	{ "^h", KEYMOD_CTRL | KEY_H },
+	{ "^i", KEYMOD_CTRL | KEY_I },
+	{ "^j", KEYMOD_CTRL | KEY_J },
+	{ "^k", KEYMOD_CTRL | KEY_K },
+	{ "^l", KEYMOD_CTRL | KEY_L },
+	{ "^m", KEYMOD_CTRL | KEY_M },
+	{ "^n", KEYMOD_CTRL | KEY_N },
+	{ "^o", KEYMOD_CTRL | KEY_O },
+	{ "^p", KEYMOD_CTRL | KEY_P },
+	{ "^q", KEYMOD_CTRL | KEY_Q },
+	{ "^r", KEYMOD_CTRL | KEY_R },
+	{ "^s", KEYMOD_CTRL | KEY_S },
+	{ "^t", KEYMOD_CTRL | KEY_T },
+	{ "^u", KEYMOD_CTRL | KEY_U },
+	{ "^v", KEYMOD_CTRL | KEY_V },
+	{ "^w", KEYMOD_CTRL | KEY_W },
+	{ "^x", KEYMOD_CTRL | KEY_X },
+	{ "^y", KEYMOD_CTRL | KEY_Y },
+	{ "^z", KEYMOD_CTRL | KEY_Z },
+	{ "^delete", KEYMOD_CTRL | KEY_DELETE },
+	{ "^n0", KEYMOD_CTRL | KEY_KP0 },
+	{ "^n1", KEYMOD_CTRL | KEY_KP1 },
+	{ "^n2", KEYMOD_CTRL | KEY_KP2 },
+	{ "^n3", KEYMOD_CTRL | KEY_KP3 },
+	{ "^n4", KEYMOD_CTRL | KEY_KP4 },
+	{ "^n5", KEYMOD_CTRL | KEY_KP5 },
+	{ "^n6", KEYMOD_CTRL | KEY_KP6 },
+	{ "^n7", KEYMOD_CTRL | KEY_KP7 },
+	{ "^n8", KEYMOD_CTRL | KEY_KP8 },
+	{ "^n9", KEYMOD_CTRL | KEY_KP9 },
+	{ "^n.", KEYMOD_CTRL | KEY_KP_PERIOD },
+	{ "^n/", KEYMOD_CTRL | KEY_KP_DIVIDE },
+	{ "^n*", KEYMOD_CTRL | KEY_KP_MULTIPLY },
+	{ "^n-", KEYMOD_CTRL | KEY_KP_MINUS },
+	{ "^n+", KEYMOD_CTRL | KEY_KP_PLUS },
+	{ "^nreturn", KEYMOD_CTRL | KEY_KP_ENTER },
+	{ "^nenter", KEYMOD_CTRL | KEY_KP_ENTER },
+	{ "^n=", KEYMOD_CTRL | KEY_KP_EQUALS },
+	{ "^up", KEYMOD_CTRL | KEY_UP },
+	{ "^down", KEYMOD_CTRL | KEY_DOWN },
+	{ "^right", KEYMOD_CTRL | KEY_RIGHT },
+	{ "^left", KEYMOD_CTRL | KEY_LEFT },
+	{ "^insert", KEYMOD_CTRL | KEY_INSERT },
+	{ "^home", KEYMOD_CTRL | KEY_HOME },
+	{ "^end", KEYMOD_CTRL | KEY_END },
+	{ "^pageup", KEYMOD_CTRL | KEY_PAGEUP },
+	{ "^pagedown", KEYMOD_CTRL | KEY_PAGEDOWN  },
+	{ "^f1", KEYMOD_CTRL | KEY_F1 },
+	{ "^f2", KEYMOD_CTRL | KEY_F2 },
+	{ "^f3", KEYMOD_CTRL | KEY_F3 },
+	{ "^f4", KEYMOD_CTRL | KEY_F4 },
+	{ "^f5", KEYMOD_CTRL | KEY_F5 },
+	{ "^f6", KEYMOD_CTRL | KEY_F6 },
+	{ "^f7", KEYMOD_CTRL | KEY_F7 },
+	{ "^f8", KEYMOD_CTRL | KEY_F8 },
+	{ "^f9", KEYMOD_CTRL | KEY_F9 },
+	{ "^f10", KEYMOD_CTRL | KEY_F10 },
+	{ "^f11", KEYMOD_CTRL | KEY_F11 },
+	{ "^f12", KEYMOD_CTRL | KEY_F12 },
+	{ "^f13", KEYMOD_CTRL | KEY_F13 },
+	{ "^f14", KEYMOD_CTRL | KEY_F14 },
+	{ "^f15", KEYMOD_CTRL | KEY_F15 },
+	{ "^numlock", KEYMOD_CTRL | KEY_NUMLOCK },
+	{ "^capslock", KEYMOD_CTRL | KEY_CAPSLOCK },
+	{ "^scrolllock", KEYMOD_CTRL | KEY_SCROLLOCK },
+	{ "^mode", KEYMOD_CTRL | KEY_MODE },
+	{ "^compose", KEYMOD_CTRL | KEY_COMPOSE },
+	{ "^help", KEYMOD_CTRL | KEY_HELP },
+	{ "^print", KEYMOD_CTRL | KEY_PRINT },
+	{ "^sysreq", KEYMOD_CTRL | KEY_SYSREQ },
+	{ "^break", KEYMOD_CTRL | KEY_BREAK },
+	{ "^menu", KEYMOD_CTRL | KEY_MENU },
+	{ "^power", KEYMOD_CTRL | KEY_POWER },
+	{ "^_", KEYMOD_CTRL | KEY_UNDERSCORE },
+	{ "^kana", KEYMOD_CTRL | KEY_KANA },
+	{ "^\\", KEYMOD_CTRL | KEY_YEN  },
+	{ "^xfer", KEYMOD_CTRL | KEY_XFER },
+	{ "^nfer", KEYMOD_CTRL | KEY_NFER },
+	{ "^non-us-backslash", KEYMOD_CTRL | KEY_NONUSBACKSLASH },
+	{ "+backspace", KEYMOD_SHIFT | KEY_BACKSPACE },
+	{ "+tab", KEYMOD_SHIFT | KEY_TAB },
+	{ "+clear", KEYMOD_SHIFT | KEY_CLEAR },
+	{ "+return", KEYMOD_SHIFT | KEY_RETURN },
+	{ "+enter", KEYMOD_SHIFT | KEY_RETURN },
+	{ "+pause", KEYMOD_SHIFT | KEY_PAUSE },
+	{ "+escape", KEYMOD_SHIFT | KEY_ESCAPE },
+	{ "+space", KEYMOD_SHIFT | KEY_SPACE },
+	{ "+:", KEYMOD_SHIFT | KEY_COLON },
+	{ "+,", KEYMOD_SHIFT | KEY_COMMA },
+	{ "+-", KEYMOD_SHIFT | KEY_MINUS },
+	{ "+.", KEYMOD_SHIFT | KEY_PERIOD },
+	{ "+/", KEYMOD_SHIFT | KEY_SLASH },
+	{ "+0", KEYMOD_SHIFT | KEY_0 },
+	{ "+1", KEYMOD_SHIFT | KEY_1 },
+	{ "+2", KEYMOD_SHIFT | KEY_2 },
+	{ "+3", KEYMOD_SHIFT | KEY_3 },
+	{ "+4", KEYMOD_SHIFT | KEY_4 },
+	{ "+5", KEYMOD_SHIFT | KEY_5 },
+	{ "+6", KEYMOD_SHIFT | KEY_6 },
+	{ "+7", KEYMOD_SHIFT | KEY_7 },
+	{ "+8", KEYMOD_SHIFT | KEY_8 },
+	{ "+9", KEYMOD_SHIFT | KEY_9 },
+	{ "+;", KEYMOD_SHIFT | KEY_SEMICOLON },
+	{ "+^", KEYMOD_SHIFT | KEY_HAT },
+	{ "+@", KEYMOD_SHIFT | KEY_AT },
+	{ "+]", KEYMOD_SHIFT | KEY_RIGHTBRACKET },
+	{ "+[", KEYMOD_SHIFT | KEY_LEFTBRACKET },
+	{ "+`", KEYMOD_SHIFT | KEY_BACKQUOTE },
+	{ "+a", KEYMOD_SHIFT | KEY_A },
+	{ "+b", KEYMOD_SHIFT | KEY_B },
+	{ "+c", KEYMOD_SHIFT | KEY_C },
+	{ "+d", KEYMOD_SHIFT | KEY_D },
+	{ "+e", KEYMOD_SHIFT | KEY_E },
+	{ "+f", KEYMOD_SHIFT | KEY_F },
+	{ "+g", KEYMOD_SHIFT | KEY_G },
+	{ "+h", KEYMOD_SHIFT | KEY_H },
+	{ "+i", KEYMOD_SHIFT | KEY_I },
+	{ "+j", KEYMOD_SHIFT | KEY_J },
+	{ "+k", KEYMOD_SHIFT | KEY_K },
+	{ "+l", KEYMOD_SHIFT | KEY_L },
+	{ "+m", KEYMOD_SHIFT | KEY_M },
+	{ "+n", KEYMOD_SHIFT | KEY_N },
+	{ "+o", KEYMOD_SHIFT | KEY_O },
+	{ "+p", KEYMOD_SHIFT | KEY_P },
+	{ "+q", KEYMOD_SHIFT | KEY_Q },
+	{ "+r", KEYMOD_SHIFT | KEY_R },
+	{ "+s", KEYMOD_SHIFT | KEY_S },
+	{ "+t", KEYMOD_SHIFT | KEY_T },
+	{ "+u", KEYMOD_SHIFT | KEY_U },
+	{ "+v", KEYMOD_SHIFT | KEY_V },
+	{ "+w", KEYMOD_SHIFT | KEY_W },
+	{ "+x", KEYMOD_SHIFT | KEY_X },
+	{ "+y", KEYMOD_SHIFT | KEY_Y },
+	{ "+z", KEYMOD_SHIFT | KEY_Z },
+	{ "+delete", KEYMOD_SHIFT | KEY_DELETE },
+	{ "+n0", KEYMOD_SHIFT | KEY_KP0 },
+	{ "+n1", KEYMOD_SHIFT | KEY_KP1 },
+	{ "+n2", KEYMOD_SHIFT | KEY_KP2 },
+	{ "+n3", KEYMOD_SHIFT | KEY_KP3 },
+	{ "+n4", KEYMOD_SHIFT | KEY_KP4 },
+	{ "+n5", KEYMOD_SHIFT | KEY_KP5 },
+	{ "+n6", KEYMOD_SHIFT | KEY_KP6 },
+	{ "+n7", KEYMOD_SHIFT | KEY_KP7 },
+	{ "+n8", KEYMOD_SHIFT | KEY_KP8 },
+	{ "+n9", KEYMOD_SHIFT | KEY_KP9 },
+	{ "+n.", KEYMOD_SHIFT | KEY_KP_PERIOD },
+	{ "+n/", KEYMOD_SHIFT | KEY_KP_DIVIDE },
+	{ "+n*", KEYMOD_SHIFT | KEY_KP_MULTIPLY },
+	{ "+n-", KEYMOD_SHIFT | KEY_KP_MINUS },
+	{ "+n+", KEYMOD_SHIFT | KEY_KP_PLUS },
+	{ "+nreturn", KEYMOD_SHIFT | KEY_KP_ENTER },
+	{ "+nenter", KEYMOD_SHIFT | KEY_KP_ENTER },
+	{ "+n=", KEYMOD_SHIFT | KEY_KP_EQUALS },
+	{ "+up", KEYMOD_SHIFT | KEY_UP },
+	{ "+down", KEYMOD_SHIFT | KEY_DOWN },
+	{ "+right", KEYMOD_SHIFT | KEY_RIGHT },
+	{ "+left", KEYMOD_SHIFT | KEY_LEFT },
+	{ "+insert", KEYMOD_SHIFT | KEY_INSERT },
+	{ "+home", KEYMOD_SHIFT | KEY_HOME },
+	{ "+end", KEYMOD_SHIFT | KEY_END },
+	{ "+pageup", KEYMOD_SHIFT | KEY_PAGEUP },
+	{ "+pagedown", KEYMOD_SHIFT | KEY_PAGEDOWN  },
+	{ "+f1", KEYMOD_SHIFT | KEY_F1 },
+	{ "+f2", KEYMOD_SHIFT | KEY_F2 },
+	{ "+f3", KEYMOD_SHIFT | KEY_F3 },
+	{ "+f4", KEYMOD_SHIFT | KEY_F4 },
+	{ "+f5", KEYMOD_SHIFT | KEY_F5 },
+	{ "+f6", KEYMOD_SHIFT | KEY_F6 },
+	{ "+f7", KEYMOD_SHIFT | KEY_F7 },
+	{ "+f8", KEYMOD_SHIFT | KEY_F8 },
+	{ "+f9", KEYMOD_SHIFT | KEY_F9 },
+	{ "+f10", KEYMOD_SHIFT | KEY_F10 },
+	{ "+f11", KEYMOD_SHIFT | KEY_F11 },
+	{ "+f12", KEYMOD_SHIFT | KEY_F12 },
+	{ "+f13", KEYMOD_SHIFT | KEY_F13 },
+	{ "+f14", KEYMOD_SHIFT | KEY_F14 },
+	{ "+f15", KEYMOD_SHIFT | KEY_F15 },
+	{ "+numlock", KEYMOD_SHIFT | KEY_NUMLOCK },
+	{ "+capslock", KEYMOD_SHIFT | KEY_CAPSLOCK },
+	{ "+scrolllock", KEYMOD_SHIFT | KEY_SCROLLOCK },
+	{ "+mode", KEYMOD_SHIFT | KEY_MODE },
+	{ "+compose", KEYMOD_SHIFT | KEY_COMPOSE },
+	{ "+help", KEYMOD_SHIFT | KEY_HELP },
+	{ "+print", KEYMOD_SHIFT | KEY_PRINT },
+	{ "+sysreq", KEYMOD_SHIFT | KEY_SYSREQ },
+	{ "+break", KEYMOD_SHIFT | KEY_BREAK },
+	{ "+menu", KEYMOD_SHIFT | KEY_MENU },
+	{ "+power", KEYMOD_SHIFT | KEY_POWER },
+	{ "+_", KEYMOD_SHIFT | KEY_UNDERSCORE },
+	{ "+kana", KEYMOD_SHIFT | KEY_KANA },
+	{ "+\\", KEYMOD_SHIFT | KEY_YEN  },
+	{ "+xfer", KEYMOD_SHIFT | KEY_XFER },
+	{ "+nfer", KEYMOD_SHIFT | KEY_NFER },
+	{ "+non-us-backslash", KEYMOD_SHIFT | KEY_NONUSBACKSLASH },
+	{ NULL, 0 }
+};
+
 /*
 	G[\
 */
@@ -207,6 +708,34 @@ static SDL_Rect *zoomBitmap(SDL_Rect *r, int zoom)
 	return r;
 }
 
+#if SDL_MAJOR_VERSION == 2
+/*
+	eNX`ɕ`悵ĕ\ (updateWindow̉)
+*/
+static void updateTexture(Z1stat *z1)
+{
+	Uint32 *p;
+	const int *q;
+	int x, y, i;
+
+	for(y = 0; y < 6; y++)
+		for(i = rectTexSymbol[y].y; i < rectTexSymbol[y].y + rectTexSymbol[y].h; i++)
+			for(x = rectTexSymbol[y].x; x < rectTexSymbol[y].x + rectTexSymbol[y].w; x++)
+				texPixels[i * rectTexPanel.w + x] = pixLCD[z1->lcd.symbol[y]];
+	for(y = 0; y < LCD_HEIGHT; y++) {
+		p = &texPixels[(rectTexLCD.y + y) * rectTexPanel.w + rectTexLCD.x];
+		q = &z1->lcd.pix[y * LCD_WIDTH];
+		for(x = 0; x < LCD_WIDTH; x++)
+			*p++ = pixLCD[*q++];
+	}
+	SDL_UpdateTexture(texPanel, NULL, texPixels, rectTexPanel.w * sizeof(Uint32));
+
+	SDL_RenderCopy(renderer, texBack, NULL, NULL);
+	SDL_RenderCopy(renderer, texPanel, NULL, &rectPanel);
+	SDL_RenderPresent(renderer);
+}
+#endif
+
 /*
 	\XV
 */
@@ -214,6 +743,13 @@ void updateWindow(Z1stat *z1)
 {
 	int lock, x, y;
 
+#if SDL_MAJOR_VERSION == 2
+	if(renderer != NULL) {
+		updateTexture(z1);
+		return;
+	}
+#endif
+
 	/* EBhEɕ`悷 */
 	if((lock = SDL_MUSTLOCK(screen)))
 		if(SDL_LockSurface(screen) < 0)
@@ -248,12 +784,11 @@ int updateKey(Z1stat *z1)
 #elif SDL_MAJOR_VERSION == 1
 	SDLMod mod;
 #endif
-	int key, intr;
+	int key, intr = -1;
 	uint16 zkey;
 
-	if((intr = autoUpdateKey(z1)) > 0)
-		return intr;
-	if(intr == 0)
+	/* ͒̓L[󂯕tȂ */
+	if(isAutoKey(z1))
 		return -1;
 
 	while(SDL_PollEvent(&e)) {
@@ -300,6 +835,11 @@ int updateKey(Z1stat *z1)
 #endif
 				break;
 			}
+			/* ^[{̐ؑւ? */
+			if((zkey & ~ZKEYMOD_MASK) == ZKEY_TURBO) {
+				setTurbo(z1, !z1->turbo.on);
+				break;
+			}
 			/* \t? */
 			if((zkey & ~ZKEYMOD_MASK) == ZKEY_PASTE) {
 #if SDL_MAJOR_VERSION == 2
@@ -344,8 +884,8 @@ int updateKey(Z1stat *z1)
 			if((zkey & ~ZKEYMOD_MASK) == 0)
 				break;
 
-			/* Rs[/\t? */
-			if((zkey & ~ZKEYMOD_MASK) == ZKEY_COPY || (zkey & ~ZKEYMOD_MASK) == ZKEY_PASTE)
+			/* Rs[/\t/^[{̐ؑւ? */
+			if((zkey & ~ZKEYMOD_MASK) == ZKEY_COPY || (zkey & ~ZKEYMOD_MASK) == ZKEY_PASTE || (zkey & ~ZKEYMOD_MASK) == ZKEY_TURBO)
 				break;
 
 			/* L[̉s */
@@ -414,21 +954,26 @@ int updateKey(Z1stat *z1)
 	return -1;
 }
 
+/* ^Cgo[̕\ */
+static char titleMsg[256] = ""; /* bZ[W */
+static int titleSpeed = -1; /* sx(%, ȂΕ\Ȃ) */
+
 /*
-	莞ԑ҂
+	EBhẼ^CgXV (setTitle, setSpeed̉)
 */
-void delay(int interval)
+static void updateTitle(void)
 {
-	static Uint32 last = 0, left;
-	Uint32 now;
-
-	now = SDL_GetTicks();
-	if(last + interval > now) {
-		left = last + interval - now;
-		SDL_Delay(left);
-		last = now + left;
-	} else
-		last = now;
+	char buf[512];
+
+	if(titleSpeed >= 0)
+		sprintf(buf, "%s %d%% %s\n", machineName, titleSpeed, titleMsg);
+	else
+		sprintf(buf, "%s %s\n", machineName, titleMsg);
+#if SDL_MAJOR_VERSION == 2
+	SDL_SetWindowTitle(window, buf);
+#elif SDL_MAJOR_VERSION == 1
+	SDL_WM_SetCaption(buf, NULL);
+#endif
 }
 
 /*
@@ -436,14 +981,19 @@ void delay(int interval)
 */
 void setTitle(const char *msg)
 {
-	char buf[256];
+	snprintf(titleMsg, sizeof(titleMsg), "%s", msg);
+	updateTitle();
+}
 
-	sprintf(buf, "%s %s\n", machineName, msg);
-#if SDL_MAJOR_VERSION == 2
-	SDL_SetWindowTitle(window, buf);
-#elif SDL_MAJOR_VERSION == 1
-	SDL_WM_SetCaption(buf, NULL);
-#endif
+/*
+	^Cgo[Ɏsx\
+*/
+void setSpeed(int percent)
+{
+	if(percent == titleSpeed)
+		return;
+	titleSpeed = percent;
+	updateTitle();
 }
 
 /*
@@ -451,13 +1001,143 @@ void setTitle(const char *msg)
 */
 static SDLCALL void playSound(void *userdata, Uint8 *stream, int len)
 {
-	struct Sound *sound = &((Z1stat *)userdata)->sound;
+	getSound(&((Z1stat *)userdata)->sound, (int8 *)stream, len);
+}
 
 #if SDL_MAJOR_VERSION == 2
-	memset(stream, 0, len);
+/*
+	_ƃeNX`쐬 (initDepend̉)
+*/
+static int initRenderer(Z1stat *z1)
+{
+	Uint32 vsync = z1->setting.render_thread ? SDL_RENDERER_PRESENTVSYNC: 0;
+	int i;
+
+	if(z1->setting.display != DISPLAY_SOFTWARE)
+		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | vsync);
+	if(renderer == NULL && (renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE)) == NULL) {
+		fprintf(stderr, "SDL_CreateRenderer fail. %s\n", SDL_GetError());
+		return FALSE;
+	}
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+	SDL_RenderSetLogicalSize(renderer, rectPanel.x + rectPanel.w, rectPanel.y + rectPanel.h);
+	if((texPanel = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, rectTexPanel.w, rectTexPanel.h)) == NULL) {
+		fprintf(stderr, "SDL_CreateTexture fail. %s\n", SDL_GetError());
+		return FALSE;
+	}
+	if((texBack = SDL_CreateTextureFromSurface(renderer, screen)) == NULL) {
+		fprintf(stderr, "SDL_CreateTextureFromSurface fail. %s\n", SDL_GetError());
+		return FALSE;
+	}
+	SDL_FreeSurface(screen);
+	screen = NULL;
+
+	/* hĂ */
+	for(i = 0; i < sizeof(texPixels) / sizeof(texPixels[0]); i++)
+		texPixels[i] = pixLCDoff;
+	updateTexture(z1);
+	return TRUE;
+}
+
+/*
+	`Xbh
+*/
+static int SDLCALL renderLoop(void *userdata)
+{
+	Z1stat *z1 = (Z1stat *)userdata;
+	const struct Frame *f;
+	uint32 last_seq = 0;
+
+	/* _͕`Xbhō쐬 */
+	if(!initRenderer(z1)) {
+		SDL_AtomicSet(&renderQuit, TRUE);
+		SDL_SemPost(renderReady);
+		return 1;
+	}
+	SDL_SemPost(renderReady);
+
+	for(;;) {
+		SDL_SemWaitTimeout(renderSem, 100);
+		while(SDL_SemTryWait(renderSem) == 0)
+			;
+		if(SDL_AtomicGet(&renderQuit))
+			break;
+
+		/* Vt[ȂΉȂ */
+		if(!(SDL_AtomicGet(&frameMiddle) & FRAME_FRESH))
+			continue;
+		frameFront = SDL_AtomicSet(&frameMiddle, frameFront) & ~FRAME_FRESH;
+		SDL_MemoryBarrierAcquire();
+		f = &frames[frameFront];
+
+		/* ԂɍȂt[̕c */
+		fadeLCD(&z1->lcd, f->vram, f->status, MIN(getLCDFade(z1) * (int )(f->seq - last_seq), 255));
+		last_seq = f->seq;
+		updateWindow(z1);
+	}
+	return 0;
+}
+
+/*
+	`XbhI
+*/
+static void stopRenderThread(void)
+{
+	if(renderThread == NULL)
+		return;
+	SDL_AtomicSet(&renderQuit, TRUE);
+	SDL_SemPost(renderSem);
+	SDL_WaitThread(renderThread, NULL);
+	renderThread = NULL;
+}
+
+/*
+	`XbhJn (initDepend̉)
+*/
+static int startRenderThread(Z1stat *z1)
+{
+	frameBack = 0;
+	SDL_AtomicSet(&frameMiddle, 1);
+	frameFront = 2;
+	SDL_AtomicSet(&renderQuit, FALSE);
+
+	if((renderSem = SDL_CreateSemaphore(0)) == NULL || (renderReady = SDL_CreateSemaphore(0)) == NULL) {
+		fprintf(stderr, "SDL_CreateSemaphore fail. %s\n", SDL_GetError());
+		return FALSE;
+	}
+	if((renderThread = SDL_CreateThread(renderLoop, "render", z1)) == NULL) {
+		fprintf(stderr, "SDL_CreateThread fail. %s\n", SDL_GetError());
+		return FALSE;
+	}
+	atexit(stopRenderThread);
+
+	/* _̍쐬҂ */
+	SDL_SemWait(renderReady);
+	if(SDL_AtomicGet(&renderQuit)) {
+		SDL_WaitThread(renderThread, NULL);
+		renderThread = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+#endif
+
+/*
+	LCD̃t[`Xbhɓn
+*/
+void postLCD(Z1stat *z1)
+{
+#if SDL_MAJOR_VERSION == 2
+	static uint32 seq = 0;
+	struct Frame *f = &frames[frameBack];
+
+	memcpy(f->vram, z1->vram.vram, sizeof(f->vram));
+	f->status = z1->vram.status;
+	f->seq = ++seq;
+	SDL_MemoryBarrierRelease();
+	frameBack = SDL_AtomicSet(&frameMiddle, frameBack | FRAME_FRESH) & ~FRAME_FRESH;
+	SDL_SemPost(renderSem);
 #endif
-	SDL_MixAudio(stream, (uint8 *)sound->buffer[sound->page], len, SDL_MIX_MAXVOLUME);
-	sound->played = TRUE;
 }
 
 /*
@@ -472,14 +1152,67 @@ static int pixToScale(int scales, int pix)
 	return (pix / (255 / (scales - 1))) * (255 / (scales - 1)) + 1;
 }
 
+/*
+	L[zuݒ肷 (initDepend̉)
+*/
+static void initKeyConv(const Conf *conf)
+{
+	uint16 key;
+	const OptTable *p;
+
+	for(p = tableZkey; p->string != NULL; p++) {
+		if(p->value & ~ZKEYMOD_MASK)
+			continue;
+		if((key = getOptTable(conf, p->string, tableKey, 0)) == 0)
+			continue;
+		keyConv[key & ~KEYMOD_MASK] = p->value;
+		keyConvAlt[key & ~KEYMOD_MASK] = p->value;
+		keyConvCtrl[key & ~KEYMOD_MASK] = p->value;
+		keyConvShift[key & ~KEYMOD_MASK] = p->value;
+	}
+
+	for(p = tableZkey; p->string != NULL; p++) {
+		if((key = getOptTable(conf, p->string, tableKey, 0)) == 0)
+			continue;
+		switch(key & KEYMOD_MASK) {
+		case 0:
+			keyConv[key & ~KEYMOD_MASK] = p->value;
+			break;
+		case KEYMOD_ALT:
+			if(p->value & ZKEYMOD_SHIFT)
+				keyConvAlt[key & ~KEYMOD_MASK] = p->value;
+			else
+				keyConvAlt[key & ~KEYMOD_MASK] = (p->value & ~ZKEYMOD_MASK) | ZKEYMOD_NOSHIFT;
+			break;
+		case KEYMOD_CTRL:
+			if(p->value & ZKEYMOD_SHIFT)
+				keyConvCtrl[key & ~KEYMOD_MASK] = p->value;
+			else
+				keyConvCtrl[key & ~KEYMOD_MASK] = (p->value & ~ZKEYMOD_MASK) | ZKEYMOD_NOSHIFT;
+			break;
+		case KEYMOD_SHIFT:
+			if(p->value & ZKEYMOD_SHIFT)
+				keyConvShift[key & ~KEYMOD_MASK] = p->value & ~ZKEYMOD_MASK;
+			else
+				keyConvShift[key & ~KEYMOD_MASK] = (p->value & ~ZKEYMOD_MASK) | ZKEYMOD_NOSHIFT;
+			break;
+		}
+	}
+}
+
 /*
 	ˑ
 */
-int initDepend(Z1stat *z1)
+int initDepend(Z1stat *z1, int argc, char *argv[])
 {
+	Conf conf[256];
 	SDL_AudioSpec audio;
 	int i, use_joy = z1->joy.right != 0 || z1->joy.left != 0 || z1->joy.up != 0 || z1->joy.down != 0 || z1->joy.button[0] != 0 || z1->joy.button[1] != 0 || z1->joy.button[2] != 0 || z1->joy.button[3] != 0 || z1->joy.button[4] != 0 || z1->joy.button[5] != 0 || z1->joy.button[6] != 0 || z1->joy.button[7] != 0 || z1->joy.button[8] != 0 || z1->joy.button[9] != 0 || z1->joy.button[10] != 0 || z1->joy.button[11] != 0 || z1->joy.button[12] != 0 || z1->joy.button[13] != 0 || z1->joy.button[14] != 0 || z1->joy.button[15] != 0;
 
+	/* L[zu */
+	if(getConfig(conf, sizeof(conf) / sizeof(conf[0]), "z1f9config", argc, argv) != NULL)
+		initKeyConv(conf);
+
 	if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | (use_joy ? SDL_INIT_JOYSTICK: 0) | (z1->sound.len > 0 ? SDL_INIT_AUDIO: 0))) {
 		fprintf(stderr, "SDL_Init fail. %s\n", SDL_GetError());
 		return FALSE;
@@ -510,13 +1243,26 @@ int initDepend(Z1stat *z1)
 	zoomRect(&rectLCD, zoom);
 
 #if SDL_MAJOR_VERSION == 2
-	if((window = SDL_CreateWindow("", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, rectPanel.x + rectPanel.w, rectPanel.y + rectPanel.h, 0)) == NULL) {
-		fprintf(stderr, "SDL_CreateWindow fail. %s\n", SDL_GetError());
-		return FALSE;
-	}
-	if((screen = SDL_GetWindowSurface(window)) == NULL) {
-		fprintf(stderr, "SDL_GetWindowSurface fail. %s", SDL_GetError());
-		return FALSE;
+	if(z1->setting.display != DISPLAY_SURFACE) {
+		if((window = SDL_CreateWindow("", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, rectPanel.x + rectPanel.w, rectPanel.y + rectPanel.h, SDL_WINDOW_RESIZABLE)) == NULL) {
+			fprintf(stderr, "SDL_CreateWindow fail. %s\n", SDL_GetError());
+			return FALSE;
+		}
+
+		/* wi̓T[tFXɕ`ĂeNX`ɂ */
+		if((screen = SDL_CreateRGBSurfaceWithFormat(0, rectPanel.x + rectPanel.w, rectPanel.y + rectPanel.h, 32, SDL_PIXELFORMAT_ARGB8888)) == NULL) {
+			fprintf(stderr, "SDL_CreateRGBSurfaceWithFormat fail. %s\n", SDL_GetError());
+			return FALSE;
+		}
+	} else {
+		if((window = SDL_CreateWindow("", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, rectPanel.x + rectPanel.w, rectPanel.y + rectPanel.h, 0)) == NULL) {
+			fprintf(stderr, "SDL_CreateWindow fail. %s\n", SDL_GetError());
+			return FALSE;
+		}
+		if((screen = SDL_GetWindowSurface(window)) == NULL) {
+			fprintf(stderr, "SDL_GetWindowSurface fail. %s", SDL_GetError());
+			return FALSE;
+		}
 	}
 #elif SDL_MAJOR_VERSION == 1
 	if((video = SDL_GetVideoInfo()) == NULL) {
@@ -555,6 +1301,28 @@ int initDepend(Z1stat *z1)
 	putBitmap(&rectGraDot, dot_bits[MIN(zoom, 3) - 1], &pixFrame, &pixText);
 	boxfill(&rectPanel, &pixLCDoff);
 
+#if SDL_MAJOR_VERSION == 2
+	/* EBhET[tFX̓EBhE쐬XbhłXVłȂ. macOSł̓_ */
+#ifdef __APPLE__
+	if(z1->setting.render_thread) {
+#else
+	if(z1->setting.render_thread && z1->setting.display == DISPLAY_SURFACE) {
+#endif
+		fprintf(stderr, "render_thread is not available with this display. ignored.\n");
+		z1->setting.render_thread = FALSE;
+	}
+
+	if(z1->setting.render_thread) {
+		if(!startRenderThread(z1))
+			return FALSE;
+	} else if(z1->setting.display != DISPLAY_SURFACE) {
+		if(!initRenderer(z1))
+			return FALSE;
+	}
+#elif SDL_MAJOR_VERSION == 1
+	z1->setting.render_thread = FALSE;
+#endif
+
 	if(use_joy)
 		if((joy = SDL_JoystickOpen(0)) == NULL)
 			;
@@ -569,6 +1337,7 @@ int initDepend(Z1stat *z1)
 		audio.userdata = z1;
 		if(SDL_OpenAudio(&audio, NULL) < 0) {
 			fprintf(stderr, "SDL_OpenAudio fail. %s", SDL_GetError());
+			z1->sound.len = 0;
 			return 1;
 		}
 		SDL_PauseAudio(0);
@@ -9,6 +9,23 @@
 #include <stdio.h>
 #include <sys/stat.h>
 #include "z1.h"
+
+#if defined(DEF_GLOBAL)
+#	define EXTERN
+#else
+#	define EXTERN	extern
+#endif
+
+/* Rrl[VL[ */
+#define KEYMOD_ALT	0x4000
+#define KEYMOD_CTRL	0x8000
+#define KEYMOD_SHIFT	0xc000
+#define KEYMOD_MASK	0xc000
+
+#if defined(Z1_HEADLESS)
+/* Oo */
+#define log(...)	fprintf(stderr, __VA_ARGS__)
+#else
 #include "SDL.h"
 
 /* G~[g鑤̃L[ */
@@ -258,12 +275,6 @@
 #define KEY_NONUSBACKSLASH	0
 #endif
 
-/* Rrl[VL[ */
-#define KEYMOD_ALT	0x4000
-#define KEYMOD_CTRL	0x8000
-#define KEYMOD_SHIFT	0xc000
-#define KEYMOD_MASK	0xc000
-
 /* Oo */
 #if SDL_MAJOR_VERSION == 2
 #define log	SDL_Log
@@ -803,6 +814,7 @@ EXTERN uint16 keyConvCtrl[KEY_LAST + 1];
 
 /* L[R[hϊe[u(SHIFT) */
 EXTERN uint16 keyConvShift[KEY_LAST + 1];
+#endif
 
 #endif
 
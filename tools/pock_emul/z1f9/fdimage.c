@@ -0,0 +1,497 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	tbs[fBXNC[W
+*/
+
+/*
+	C[W̌` (lׂ͂ăgGfBA)
+
+	wb_ (FDIMAGE_HEADER_SIZEoCg)
+		+0	"Z1FDIMG\0"
+		+8	o[W (2oCg)
+		+10	fBNg̍ڐ (2oCg)
+		+12	f[^̈̐擪̈ʒu (4oCg)
+		+16	f[^̈̑傫 (4oCg)
+		+20	f[^̈̎gpς̖ (4oCg)
+	fBNg (FDIMAGE_ENTRY_SIZEoCg~ڐ)
+		+0	t@C (11oCg)
+		+11	 ('A' or 'B', 0ȂΖgp)
+		+12	f[^̈̈ʒu (4oCg)
+		+16	TCY (4oCg)
+	f[^̈
+*/
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "z1.h"
+
+#define FDIMAGE_MAGIC	"Z1FDIMG"
+#define FDIMAGE_VERSION	1
+#define FDIMAGE_HEADER_SIZE	64
+#define FDIMAGE_ENTRY_SIZE	32
+
+/*
+	gGfBA̒lǂݏ ()
+*/
+static uint32 get32(const uint8 *p)
+{
+	return (uint32 )p[0] | ((uint32 )p[1] << 8) | ((uint32 )p[2] << 16) | ((uint32 )p[3] << 24);
+}
+static void put32(uint8 *p, uint32 x)
+{
+	p[0] = x & 0xff;
+	p[1] = (x >> 8) & 0xff;
+	p[2] = (x >> 16) & 0xff;
+	p[3] = (x >> 24) & 0xff;
+}
+
+/*
+	fBNg̍ڐ𓾂 ()
+*/
+static int getEntries(const struct Disk *disk)
+{
+	return disk->image[10] | (disk->image[11] << 8);
+}
+
+/*
+	fBNg̍ڂ𓾂 ()
+*/
+static uint8 *getEntry(const struct Disk *disk, int i)
+{
+	return disk->image + FDIMAGE_HEADER_SIZE + i * FDIMAGE_ENTRY_SIZE;
+}
+
+/*
+	f[^̈𓾂 ()
+*/
+static uint8 *getData(const struct Disk *disk)
+{
+	return disk->image + get32(disk->image + 12);
+}
+
+/*
+	t@CT ()
+*/
+static uint8 *findEntry(const struct Disk *disk, const uint8 *file)
+{
+	uint8 *e;
+	int i;
+
+	for(i = 0; i < getEntries(disk); i++) {
+		e = getEntry(disk, i);
+		if(e[11] != 0 && memcmp(e, file, 11) == 0)
+			return e;
+	}
+	return NULL;
+}
+
+/*
+	ڂʒȕɕׂ (compactDatả)
+*/
+static int compareOffset(const void *a, const void *b)
+{
+	uint32 x = get32(*(uint8 * const *)a + 12), y = get32(*(uint8 * const *)b + 12);
+
+	return x < y ? -1: x > y ? 1: 0;
+}
+
+/*
+	f[^̈̋󂫂l߂ ()
+*/
+static void compactData(struct Disk *disk)
+{
+	uint8 *data = getData(disk), **list, *e;
+	uint32 used = 0;
+	int i, n = 0;
+
+	if((list = malloc(sizeof(*list) * (getEntries(disk) + 1))) == NULL)
+		return;
+	for(i = 0; i < getEntries(disk); i++)
+		if((e = getEntry(disk, i))[11] != 0)
+			list[n++] = e;
+	qsort(list, n, sizeof(*list), compareOffset);
+
+	/* ʒȕɑOɋl߂ */
+	for(i = 0; i < n; i++) {
+		if(get32(list[i] + 12) != used) {
+			memmove(data + used, data + get32(list[i] + 12), get32(list[i] + 16));
+			put32(list[i] + 12, used);
+		}
+		used += get32(list[i] + 16);
+	}
+	put32(disk->image + 20, used);
+	free(list);
+}
+
+/*
+	fBXNC[W̕ύXt@Cɏo
+	(IłȂt@C邽тɏo, ُIĂȂ悤ɂ)
+*/
+static void syncFdImage(struct Disk *disk)
+{
+#ifdef _WIN32
+	FILE *fp;
+
+	if((fp = fopen(disk->image_path, "r+b")) != NULL) {
+		fwrite(disk->image, 1, disk->image_size, fp);
+		fclose(fp);
+	}
+#else
+	msync(disk->image, disk->image_size, MS_ASYNC);
+#endif
+}
+
+/*
+	fBXNC[W
+*/
+void closeFdImage(struct Disk *disk)
+{
+	if(disk->image == NULL)
+		return;
+	if(disk->image_file != NULL)
+		closeFdImageFile(disk);
+	syncFdImage(disk);
+#ifdef _WIN32
+	free(disk->image);
+#else
+	munmap(disk->image, disk->image_size);
+#endif
+	disk->image = NULL;
+}
+
+/*
+	wb_ƃfBNg? (openFdImagẻ)
+*/
+static int checkFdImage(const struct Disk *disk)
+{
+	const uint8 *e;
+	uint32 data_size, offset;
+	int i;
+
+	if(memcmp(disk->image, FDIMAGE_MAGIC, 8) != 0 || (disk->image[8] | (disk->image[9] << 8)) != FDIMAGE_VERSION)
+		return FALSE;
+	if(get32(disk->image + 12) < FDIMAGE_HEADER_SIZE + getEntries(disk) * FDIMAGE_ENTRY_SIZE || (uint64 )get32(disk->image + 12) + get32(disk->image + 16) > disk->image_size)
+		return FALSE;
+
+	/* t@Cf[^̈悩͂ݏoĂȂ? */
+	data_size = get32(disk->image + 16);
+	for(i = 0; i < getEntries(disk); i++) {
+		e = getEntry(disk, i);
+		if(e[11] != 0 && ((offset = get32(e + 12)) > data_size || get32(e + 16) > data_size - offset))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+	fBXNC[WJ
+*/
+int openFdImage(struct Disk *disk, const char *path)
+{
+	uint8 *e;
+	uint32 end, used = 0;
+	int i;
+#ifdef _WIN32
+	FILE *fp;
+	long size;
+
+	if((fp = fopen(path, "rb")) == NULL)
+		return FALSE;
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if(size < FDIMAGE_HEADER_SIZE || (disk->image = malloc(size)) == NULL) {
+		fclose(fp);
+		return FALSE;
+	}
+	fread(disk->image, 1, size, fp);
+	fclose(fp);
+	disk->image_size = size;
+#else
+	int fd;
+	struct stat st;
+
+	if((fd = open(path, O_RDWR)) < 0)
+		return FALSE;
+	if(fstat(fd, &st) < 0 || st.st_size < FDIMAGE_HEADER_SIZE) {
+		close(fd);
+		return FALSE;
+	}
+	disk->image = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(disk->image == MAP_FAILED) {
+		disk->image = NULL;
+		return FALSE;
+	}
+	disk->image_size = st.st_size;
+#endif
+
+	/* wb_ƃfBNgmF */
+	if(!checkFdImage(disk)) {
+#ifdef _WIN32
+		free(disk->image);
+#else
+		munmap(disk->image, disk->image_size);
+#endif
+		disk->image = NULL;
+		return FALSE;
+	}
+
+	strcpy(disk->image_path, path);
+	disk->image_file = NULL;
+
+	/* ɏIt@CΎgpς̖𒼂 */
+	for(i = 0; i < getEntries(disk); i++) {
+		e = getEntry(disk, i);
+		if(e[11] != 0 && (end = get32(e + 12) + get32(e + 16)) > used)
+			used = end;
+	}
+	put32(disk->image + 20, used);
+	return TRUE;
+}
+
+/*
+	tbs[fBXN̋󂫗eʂ𓾂
+*/
+uint8 getFdImageFreeSize(struct Disk *disk, uint32 *size)
+{
+	uint8 *e;
+	uint32 free = get32(disk->image + 16);
+	int i;
+
+	for(i = 0; i < getEntries(disk); i++) {
+		e = getEntry(disk, i);
+		if(e[11] != 0)
+			free -= MIN(get32(e + 16), free);
+	}
+	*size = free / 1024;
+	return 0x00;
+}
+
+/*
+	tbs[fBXÑt@CI[v
+*/
+uint8 openFdImageFile(struct Disk *disk, const uint8 *file, const uint8 *mode)
+{
+	uint8 *e, *data = getData(disk), *tmp;
+	uint32 size;
+	int i;
+
+	if(disk->image_file != NULL) {
+		closeFdImageFile(disk);
+		return 0x03; /* NR error */
+	}
+
+	e = findEntry(disk, file);
+	if(*mode == 'R') {
+		if(e == NULL)
+			return 0x02; /* FL error */
+	} else if(*mode == 'W' || *mode == 'A') {
+		/* ǋLȂΓe𖖔Ɉڂ */
+		if(e != NULL && *mode == 'A') {
+			size = get32(e + 16);
+			if((tmp = malloc(size + 1)) == NULL)
+				return 0x07; /* PR error */
+			memcpy(tmp, data + get32(e + 12), size);
+			e[11] = 0;
+			compactData(disk);
+			put32(e + 12, get32(disk->image + 20));
+			memcpy(data + get32(e + 12), tmp, size);
+			free(tmp);
+		} else {
+			if(e != NULL)
+				e[11] = 0;
+			else
+				for(i = 0; i < getEntries(disk) && e == NULL; i++)
+					if(getEntry(disk, i)[11] == 0)
+						e = getEntry(disk, i);
+			if(e == NULL)
+				return 0x0b; /* DF error */
+			compactData(disk);
+			memcpy(e, file, 11);
+			put32(e + 12, get32(disk->image + 20));
+			put32(e + 16, 0);
+		}
+		e[11] = 'A';
+	} else
+		return 0x07; /* PR error */
+
+	disk->image_file = e;
+	disk->writing = (*mode != 'R');
+	disk->size = get32(e + 16);
+	disk->pos = (*mode == 'A' ? disk->size: 0);
+	return 0x00;
+}
+
+/*
+	tbs[fBXÑt@CN[Y
+*/
+uint8 closeFdImageFile(struct Disk *disk)
+{
+	uint8 *e = disk->image_file, *p;
+
+	if(e == NULL)
+		return 0x00;
+
+	if(disk->writing) {
+		/* 񂾕gpςɂ */
+		put32(e + 16, disk->pos);
+		put32(disk->image + 20, get32(e + 12) + disk->pos);
+
+		p = getData(disk) + get32(e + 12);
+		e[11] = (disk->pos >= 2 && p[0] == 0xff && p[1] == 0xfe ? 'B': 'A');
+		syncFdImage(disk);
+	}
+	disk->image_file = NULL;
+	return 0x00;
+}
+
+/*
+	tbs[fBXÑt@Cǂݍ
+*/
+uint8 readFdImageFile(struct Disk *disk, uint8 *data)
+{
+	uint8 *e = disk->image_file;
+
+	if(e == NULL)
+		return 0x03; /* NR error */
+
+	if(disk->pos >= get32(e + 16)) {
+		disk->image_file = NULL;
+		return 0x0b; /* DF error */
+	}
+	*data = getData(disk)[get32(e + 12) + disk->pos++];
+	return 0x00;
+}
+
+/*
+	tbs[fBXÑt@Cɏ
+*/
+uint8 writeFdImageFile(struct Disk *disk, uint8 data, const uint8 *size)
+{
+	uint8 *e = disk->image_file;
+
+	if(e == NULL)
+		return 0x00;
+
+	/* f[^̖̈܂ŏ߂ */
+	if(get32(e + 12) + disk->pos >= get32(disk->image + 16)) {
+		closeFdImageFile(disk);
+		return 0x0b; /* DF error */
+	}
+	getData(disk)[get32(e + 12) + disk->pos++] = data;
+
+	if(size != NULL && disk->pos >= get32(size))
+		closeFdImageFile(disk);
+	return 0x00;
+}
+
+/*
+	tbs[fBXÑt@CύX
+*/
+uint8 renameFdImageFile(struct Disk *disk, const uint8 *old_file, const uint8 *new_file)
+{
+	uint8 *e;
+
+	if((e = findEntry(disk, old_file)) == NULL)
+		return 0x02; /* FL error */
+	if(findEntry(disk, new_file) != NULL)
+		return 0x07; /* PR error */
+	memcpy(e, new_file, 11);
+	syncFdImage(disk);
+	return 0x00;
+}
+
+/*
+	tbs[fBXÑt@C폜
+*/
+uint8 deleteFdImageFile(struct Disk *disk, const uint8 *file)
+{
+	uint8 *e;
+
+	if((e = findEntry(disk, file)) == NULL)
+		return 0x02; /* FL error */
+	e[11] = 0;
+	syncFdImage(disk);
+	return 0x00;
+}
+
+/*
+	tbs[fBXÑt@C
+*/
+uint8 findFdImageFile(struct Disk *disk, const uint8 *wild, uint8 *data)
+{
+	const uint8 *e;
+	uint8 *p;
+	int n = 0, i, j;
+
+	disk->files = realloc(disk->files, 20 * getEntries(disk) + 1);
+
+	for(i = 0; i < getEntries(disk) && n < 0xff; i++) {
+		e = getEntry(disk, i);
+		if(e[11] == 0 || get32(e + 16) == 0 || e == disk->image_file)
+			continue;
+		for(j = 0; j < 11; j++)
+			if(e[j] != wild[j] && wild[j] != '?')
+				break;
+		if(j < 11)
+			continue;
+
+		p = disk->files + n * 20;
+		memcpy(p, e, 11);
+		memset(p + 11, 0, 4);
+		memcpy(p + 15, e + 16, 4);
+		p[19] = e[11];
+		n++;
+	}
+
+	disk->files_p = disk->files;
+	*data = n;
+	return 0x00;
+}
+
+/*
+	tbs[fBXNtH[}bg
+*/
+uint8 formatFdImage(struct Disk *disk)
+{
+	disk->image_file = NULL;
+	memset(disk->image + FDIMAGE_HEADER_SIZE, 0, getEntries(disk) * FDIMAGE_ENTRY_SIZE);
+	put32(disk->image + 20, 0);
+	syncFdImage(disk);
+	return 0x00;
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
@@ -0,0 +1,127 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	ˑ (ʁEEL[{[hȂ)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#endif
+#include "z1.h"
+
+/* W͂ǂނ? */
+static int useStdin = TRUE;
+
+/*
+	G[\
+*/
+void showError(const char *format, ...)
+{
+	va_list v;
+
+	va_start(v, format);
+	vfprintf(stderr, format, v);
+	va_end(v);
+}
+
+/*
+	EBhEXV (Ȃ)
+*/
+void updateWindow(Z1stat *z1)
+{
+}
+
+/*
+	LCD̃t[`Xbhɓn (Ȃ)
+*/
+void postLCD(Z1stat *z1)
+{
+}
+
+/*
+	L[̏ԂXV (W͂͂͂)
+*/
+int updateKey(Z1stat *z1)
+{
+#ifndef _WIN32
+	struct pollfd pfd;
+	char buf[256], *p;
+	int size;
+
+	if(!useStdin || isAutoKey(z1))
+		return -1;
+
+	pfd.fd = 0;
+	pfd.events = POLLIN;
+	if(poll(&pfd, 1, 0) <= 0)
+		return -1;
+	if((size = read(0, buf, sizeof(buf) - 1)) <= 0) {
+		useStdin = FALSE;
+		return -1;
+	}
+	buf[size] = 0;
+
+	/* sRETURNL[ɂ */
+	for(p = buf; *p != 0; p++)
+		if(*p == '\n')
+			*p = '\r';
+	setAutoText(z1, buf);
+#endif
+	return -1;
+}
+
+/*
+	EBhẼ^Cgݒ肷 (Ȃ)
+*/
+void setTitle(const char *msg)
+{
+}
+
+/*
+	^Cgo[Ɏsx\ (Ȃ)
+*/
+void setSpeed(int percent)
+{
+}
+
+/*
+	ˑ
+*/
+int initDepend(Z1stat *z1, int argc, char *argv[])
+{
+	/* ͏oȂ(^͂ł) */
+	z1->sound.len = 0;
+	z1->setting.render_thread = FALSE;
+	return TRUE;
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
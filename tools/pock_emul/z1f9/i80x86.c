@@ -1644,7 +1644,7 @@
 	_INT(0x01); \
 	i86->i.op_states += 42;
 
-static int op_length[] = {
+const static int op_length[] = {
 	2, 2, 2, 2, 2, 3, 1, 1,	/* 0x00~0x07 */
 	2, 2, 2, 2, 2, 3, 1, 1,	/* 0x08~0x0f */
 	2, 2, 2, 2, 2, 3, 1, 1,	/* 0x10~0x17 */
@@ -1678,7 +1678,7 @@ static int op_length[] = {
 	1, 1, 1, 1, 1, 1, 2, 2,	/* 0xf0~0xf7 */
 	1, 1, 1, 1, 1, 1, 2, 2	/* 0xf8~0xff */
 };
-static int regrm_length[] = {
+const static int regrm_length[] = {
 	0, 0, 0, 0, 0, 0, 2, 0,
 	0, 0, 0, 0, 0, 0, 2, 0,
 	0, 0, 0, 0, 0, 0, 2, 0,
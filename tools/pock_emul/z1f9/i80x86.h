@@ -5,7 +5,13 @@
 #if !defined(I8086_H)
 
 #include <stdio.h>
-#if defined(I86_USE_SDL)
+#if defined(__BYTE_ORDER__)
+#	if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#		define I86_LITTLEENDIAN	1
+#	else
+#		define I86_BIGENDIAN	1
+#	endif
+#elif defined(I86_USE_SDL)
 #	include "SDL.h"
 #	if SDL_BYTEORDER == SDL_LIL_ENDIAN
 #		define I86_LITTLEENDIAN	1
@@ -385,7 +385,7 @@ const char *op_grp2[] = {
 
 static char *s8(int8 val)
 {
-	static char buf[8];
+	static __thread char buf[8];
 
 	if(val > 0)
 		sprintf(buf, "+%02x", val);
@@ -396,7 +396,7 @@ static char *s8(int8 val)
 
 static char *s16(int16 val)
 {
-	static char buf[8];
+	static __thread char buf[8];
 
 	if(val > 0)
 		sprintf(buf, "+%04x", val);
@@ -443,7 +443,7 @@ static void getsegoff(I86stat *i86, uint8 rm, uint16 *seg, uint16 *off)
 
 static char *rm8val(I86stat *i86, uint8 rm)
 {
-	static char buf[32];
+	static __thread char buf[32];
 	uint16 seg, off;
 
 	if((rm & 0x18) == 0x18)
@@ -457,7 +457,7 @@ static char *rm8val(I86stat *i86, uint8 rm)
 
 static char *rm16val(I86stat *i86, uint8 rm)
 {
-	static char buf[32];
+	static __thread char buf[32];
 	uint16 seg, off;
 
 	if((rm & 0x18) == 0x18)
@@ -18,8 +18,33 @@ const static OptTable tableMachine[] = {
 	{ NULL, 0 }
 };
 
+/* \ */
+const static OptTable tableDisplay[] = {
+	{ "surface", DISPLAY_SURFACE },
+	{ "texture", DISPLAY_TEXTURE },
+	{ "software", DISPLAY_SOFTWARE },
+	{ NULL, 0 }
+};
+
+/* x̒ */
+const static OptTable tablePacing[] = {
+	{ "timer", PACING_TIMER },
+	{ "audio", PACING_AUDIO },
+	{ NULL, 0 }
+};
+
+/* Lv`` */
+const static OptTable tableCapture[] = {
+	{ "none", CAPTURE_NONE },
+	{ "pbm", CAPTURE_PBM },
+	{ "pgm", CAPTURE_PGM },
+	{ "png", CAPTURE_PNG },
+	{ "raw", CAPTURE_RAW },
+	{ NULL, 0 }
+};
+
 /* Z-1/FX-890P̃L[ */
-const static OptTable tableZkey[] = {
+const OptTable tableZkey[] = {
 	{ "brk", ZKEY_BRK },
 	{ "tab", ZKEY_TAB },
 	{ "q", ZKEY_Q },
@@ -103,6 +128,7 @@ const static OptTable tableZkey[] = {
 	{ "ans", ZKEY_ANS },
 	{ "tan", ZKEY_TAN },
 	{ "off", ZKEY_OFF }, /* zL[ */
+	{ "toggle_turbo", ZKEY_TURBO }, /* zL[ */
 	{ "copy", ZKEY_COPY }, /* zL[ */
 	{ "paste", ZKEY_PASTE }, /* zL[ */
 	{ "rewind_inport", ZKEY_REWIND_INPORT }, /* zL[ */
@@ -145,7 +171,7 @@ const static OptTable tableZkey[] = {
 	{ "ftop", ZKEYMOD_SHIFT | ZKEY_UP },
 	{ "lend", ZKEYMOD_SHIFT | ZKEY_RIGHT },
 	{ "p0", ZKEYMOD_SHIFT | ZKEY_0 },
-	{ "submenu", ZKEYMOD_SHIFT | KEY_MENU },
+	{ "submenu", ZKEYMOD_SHIFT | ZKEY_MENU },
 	{ "10^", ZKEYMOD_SHIFT | ZKEY_LOG },
 	{ "min", ZKEYMOD_SHIFT | ZKEY_MR },
 	{ "p7", ZKEYMOD_SHIFT | ZKEY_7 },
@@ -181,508 +207,34 @@ const static OptTable tableZkey[] = {
 	{ NULL, 0 }
 };
 
-/* ΉtL[ */
-static OptTable tableKey[512] = {
-	{ "none", 0 },
-	{ "backspace", KEY_BACKSPACE },
-	{ "tab", KEY_TAB },
-	{ "clear", KEY_CLEAR },
-	{ "return", KEY_RETURN },
-	{ "enter", KEY_RETURN },
-	{ "pause", KEY_PAUSE },
-	{ "escape", KEY_ESCAPE },
-	{ "space", KEY_SPACE },
-	{ ":", KEY_COLON },
-	{ ",", KEY_COMMA },
-	{ "-", KEY_MINUS },
-	{ ".", KEY_PERIOD },
-	{ "/", KEY_SLASH },
-	{ "0", KEY_0 },
-	{ "1", KEY_1 },
-	{ "2", KEY_2 },
-	{ "3", KEY_3 },
-	{ "4", KEY_4 },
-	{ "5", KEY_5 },
-	{ "6", KEY_6 },
-	{ "7", KEY_7 },
-	{ "8", KEY_8 },
-	{ "9", KEY_9 },
-	{ ";", KEY_SEMICOLON },
-	{ "^", KEY_HAT },
-	{ "@", KEY_AT },
-	{ "]", KEY_RIGHTBRACKET },
-	{ "[", KEY_LEFTBRACKET },
-	{ "`", KEY_BACKQUOTE },
-	{ "a", KEY_A },
-	{ "b", KEY_B },
-	{ "c", KEY_C },
-	{ "d", KEY_D },
-	{ "e", KEY_E },
-	{ "f", KEY_F },
-	{ "g", KEY_G },
-	{ "h", KEY_H },
-	{ "i", KEY_I },
-	{ "j", KEY_J },
-	{ "k", KEY_K },
-	{ "l", KEY_L },
-	{ "m", KEY_M },
-	{ "n", KEY_N },
-	{ "o", KEY_O },
-	{ "p", KEY_P },
-	{ "q", KEY_Q },
-	{ "r", KEY_R },
-	{ "s", KEY_S },
-	{ "t", KEY_T },
-	{ "u", KEY_U },
-	{ "v", KEY_V },
-	{ "w", KEY_W },
-	{ "x", KEY_X },
-	{ "y", KEY_Y },
-	{ "z", KEY_Z },
-	{ "delete", KEY_DELETE },
-	{ "n0", KEY_KP0 },
-	{ "n1", KEY_KP1 },
-	{ "n2", KEY_KP2 },
-	{ "n3", KEY_KP3 },
-	{ "n4", KEY_KP4 },
-	{ "n5", KEY_KP5 },
-	{ "n6", KEY_KP6 },
-	{ "n7", KEY_KP7 },
-	{ "n8", KEY_KP8 },
-	{ "n9", KEY_KP9 },
-	{ "n.", KEY_KP_PERIOD },
-	{ "n/", KEY_KP_DIVIDE },
-	{ "n*", KEY_KP_MULTIPLY },
-	{ "n-", KEY_KP_MINUS },
-	{ "n+", KEY_KP_PLUS },
-	{ "nreturn", KEY_KP_ENTER },
-	{ "nenter", KEY_KP_ENTER },
-	{ "n=", KEY_KP_EQUALS },
-	{ "up", KEY_UP },
-	{ "down", KEY_DOWN },
-	{ "right", KEY_RIGHT },
-	{ "left", KEY_LEFT },
-	{ "insert", KEY_INSERT },
-	{ "home", KEY_HOME },
-	{ "end", KEY_END },
-	{ "pageup", KEY_PAGEUP },
-	{ "pagedown", KEY_PAGEDOWN  },
-	{ "f1", KEY_F1 },
-	{ "f2", KEY_F2 },
-	{ "f3", KEY_F3 },
-	{ "f4", KEY_F4 },
-	{ "f5", KEY_F5 },
-	{ "f6", KEY_F6 },
-	{ "f7", KEY_F7 },
-	{ "f8", KEY_F8 },
-	{ "f9", KEY_F9 },
-	{ "f10", KEY_F10 },
-	{ "f11", KEY_F11 },
-	{ "f12", KEY_F12 },
-	{ "f13", KEY_F13 },
-	{ "f14", KEY_F14 },
-	{ "f15", KEY_F15 },
-	{ "numlock", KEY_NUMLOCK },
-	{ "capslock", KEY_CAPSLOCK },
-	{ "scrolllock", KEY_SCROLLOCK },
-	{ "rshift", KEY_RSHIFT },
-	{ "lshift", KEY_LSHIFT },
-	{ "rctrl", KEY_RCTRL },
-	{ "lctrl", KEY_LCTRL },
-	{ "ralt", KEY_RALT },
-	{ "lalt", KEY_LALT },
-	{ "mode", KEY_MODE },
-	{ "compose", KEY_COMPOSE },
-	{ "help", KEY_HELP },
-	{ "print", KEY_PRINT },
-	{ "sysreq", KEY_SYSREQ },
-	{ "break", KEY_BREAK },
-	{ "menu", KEY_MENU },
-	{ "power", KEY_POWER },
-	{ "_", KEY_UNDERSCORE },
-	{ "kana", KEY_KANA },
-	{ "\\", KEY_YEN  },
-	{ "xfer", KEY_XFER },
-	{ "nfer", KEY_NFER },
-	{ "non-us-backslash", KEY_NONUSBACKSLASH },
-	{ "%backspace", KEYMOD_ALT | KEY_BACKSPACE },
-	{ "%tab", KEYMOD_ALT | KEY_TAB },
-	{ "%clear", KEYMOD_ALT | KEY_CLEAR },
-	{ "%return", KEYMOD_ALT | KEY_RETURN },
-	{ "%enter", KEYMOD_ALT | KEY_RETURN },
-	{ "%pause", KEYMOD_ALT | KEY_PAUSE },
-	{ "%escape", KEYMOD_ALT | KEY_ESCAPE },
-	{ "%space", KEYMOD_ALT | KEY_SPACE },
-	{ "%:", KEYMOD_ALT | KEY_COLON },
-	{ "%,", KEYMOD_ALT | KEY_COMMA },
-	{ "%-", KEYMOD_ALT | KEY_MINUS },
-	{ "%.", KEYMOD_ALT | KEY_PERIOD },
-	{ "%/", KEYMOD_ALT | KEY_SLASH },
-	{ "%0", KEYMOD_ALT | KEY_0 },
-	{ "%1", KEYMOD_ALT | KEY_1 },
-	{ "%2", KEYMOD_ALT | KEY_2 },
-	{ "%3", KEYMOD_ALT | KEY_3 },
-	{ "%4", KEYMOD_ALT | KEY_4 },
-	{ "%5", KEYMOD_ALT | KEY_5 },
-	{ "%6", KEYMOD_ALT | KEY_6 },
-	{ "%7", KEYMOD_ALT | KEY_7 },
-	{ "%8", KEYMOD_ALT | KEY_8 },
-	{ "%9", KEYMOD_ALT | KEY_9 },
-	{ "%;", KEYMOD_ALT | KEY_SEMICOLON },
-	{ "%^", KEYMOD_ALT | KEY_HAT },
-	{ "%@", KEYMOD_ALT | KEY_AT },
-	{ "%]", KEYMOD_ALT | KEY_RIGHTBRACKET },
-	{ "%[", KEYMOD_ALT | KEY_LEFTBRACKET },
-	{ "%`", KEYMOD_ALT | KEY_BACKQUOTE },
-	{ "%a", KEYMOD_ALT | KEY_A },
-	{ "%b", KEYMOD_ALT | KEY_B },
-	{ "%c", KEYMOD_ALT | KEY_C },
-	{ "%d", KEYMOD_ALT | KEY_D },
-	{ "%e", KEYMOD_ALT | KEY_E },
-	{ "%f", KEYMOD_ALT | KEY_F },
-	{ "%g", KEYMOD_ALT | KEY_G },
-	{ "%h", KEYMOD_ALT | KEY_H },
-	{ "%i", KEYMOD_ALT | KEY_I },
-	{ "%j", KEYMOD_ALT | KEY_J },
-	{ "%k", KEYMOD_ALT | KEY_K },
-	{ "%l", KEYMOD_ALT | KEY_L },
-	{ "%m", KEYMOD_ALT | KEY_M },
-	{ "%n", KEYMOD_ALT | KEY_N },
-	{ "%o", KEYMOD_ALT | KEY_O },
-	{ "%p", KEYMOD_ALT | KEY_P },
-	{ "%q", KEYMOD_ALT | KEY_Q },
-	{ "%r", KEYMOD_ALT | KEY_R },
-	{ "%s", KEYMOD_ALT | KEY_S },
-	{ "%t", KEYMOD_ALT | KEY_T },
-	{ "%u", KEYMOD_ALT | KEY_U },
-	{ "%v", KEYMOD_ALT | KEY_V },
-	{ "%w", KEYMOD_ALT | KEY_W },
-	{ "%x", KEYMOD_ALT | KEY_X },
-	{ "%y", KEYMOD_ALT | KEY_Y },
-	{ "%z", KEYMOD_ALT | KEY_Z },
-	{ "%delete", KEYMOD_ALT | KEY_DELETE },
-	{ "%n0", KEYMOD_ALT | KEY_KP0 },
-	{ "%n1", KEYMOD_ALT | KEY_KP1 },
-	{ "%n2", KEYMOD_ALT | KEY_KP2 },
-	{ "%n3", KEYMOD_ALT | KEY_KP3 },
-	{ "%n4", KEYMOD_ALT | KEY_KP4 },
-	{ "%n5", KEYMOD_ALT | KEY_KP5 },
-	{ "%n6", KEYMOD_ALT | KEY_KP6 },
-	{ "%n7", KEYMOD_ALT | KEY_KP7 },
-	{ "%n8", KEYMOD_ALT | KEY_KP8 },
-	{ "%n9", KEYMOD_ALT | KEY_KP9 },
-	{ "%n.", KEYMOD_ALT | KEY_KP_PERIOD },
-	{ "%n/", KEYMOD_ALT | KEY_KP_DIVIDE },
-	{ "%n*", KEYMOD_ALT | KEY_KP_MULTIPLY },
-	{ "%n-", KEYMOD_ALT | KEY_KP_MINUS },
-	{ "%n+", KEYMOD_ALT | KEY_KP_PLUS },
-	{ "%nreturn", KEYMOD_ALT | KEY_KP_ENTER },
-	{ "%nenter", KEYMOD_ALT | KEY_KP_ENTER },
-	{ "%n=", KEYMOD_ALT | KEY_KP_EQUALS },
-	{ "%up", KEYMOD_ALT | KEY_UP },
-	{ "%down", KEYMOD_ALT | KEY_DOWN },
-	{ "%right", KEYMOD_ALT | KEY_RIGHT },
-	{ "%left", KEYMOD_ALT | KEY_LEFT },
-	{ "%insert", KEYMOD_ALT | KEY_INSERT },
-	{ "%home", KEYMOD_ALT | KEY_HOME },
-	{ "%end", KEYMOD_ALT | KEY_END },
-	{ "%pageup", KEYMOD_ALT | KEY_PAGEUP },
-	{ "%pagedown", KEYMOD_ALT | KEY_PAGEDOWN  },
-	{ "%f1", KEYMOD_ALT | KEY_F1 },
-	{ "%f2", KEYMOD_ALT | KEY_F2 },
-	{ "%f3", KEYMOD_ALT | KEY_F3 },
-	{ "%f4", KEYMOD_ALT | KEY_F4 },
-	{ "%f5", KEYMOD_ALT | KEY_F5 },
-	{ "%f6", KEYMOD_ALT | KEY_F6 },
-	{ "%f7", KEYMOD_ALT | KEY_F7 },
-	{ "%f8", KEYMOD_ALT | KEY_F8 },
-	{ "%f9", KEYMOD_ALT | KEY_F9 },
-	{ "%f10", KEYMOD_ALT | KEY_F10 },
-	{ "%f11", KEYMOD_ALT | KEY_F11 },
-	{ "%f12", KEYMOD_ALT | KEY_F12 },
-	{ "%f13", KEYMOD_ALT | KEY_F13 },
-	{ "%f14", KEYMOD_ALT | KEY_F14 },
-	{ "%f15", KEYMOD_ALT | KEY_F15 },
-	{ "%numlock", KEYMOD_ALT | KEY_NUMLOCK },
-	{ "%capslock", KEYMOD_ALT | KEY_CAPSLOCK },
-	{ "%scrolllock", KEYMOD_ALT | KEY_SCROLLOCK },
-	{ "%mode", KEYMOD_ALT | KEY_MODE },
-	{ "%compose", KEYMOD_ALT | KEY_COMPOSE },
-	{ "%help", KEYMOD_ALT | KEY_HELP },
-	{ "%print", KEYMOD_ALT | KEY_PRINT },
-	{ "%sysreq", KEYMOD_ALT | KEY_SYSREQ },
-	{ "%break", KEYMOD_ALT | KEY_BREAK },
-	{ "%menu", KEYMOD_ALT | KEY_MENU },
-	{ "%power", KEYMOD_ALT | KEY_POWER },
-	{ "%_", KEYMOD_ALT | KEY_UNDERSCORE },
-	{ "%kana", KEYMOD_ALT | KEY_KANA },
-	{ "%\\", KEYMOD_ALT | KEY_YEN  },
-	{ "%xfer", KEYMOD_ALT | KEY_XFER },
-	{ "%nfer", KEYMOD_ALT | KEY_NFER },
-	{ "%non-us-backslash", KEYMOD_ALT | KEY_NONUSBACKSLASH },
-	{ "^backspace", KEYMOD_CTRL | KEY_BACKSPACE },
-	{ "^tab", KEYMOD_CTRL | KEY_TAB },
-	{ "^clear", KEYMOD_CTRL | KEY_CLEAR },
-	{ "^return", KEYMOD_CTRL | KEY_RETURN },
-	{ "^enter", KEYMOD_CTRL | KEY_RETURN },
-	{ "^pause", KEYMOD_CTRL | KEY_PAUSE },
-	{ "^escape", KEYMOD_CTRL | KEY_ESCAPE },
-	{ "^space", KEYMOD_CTRL | KEY_SPACE },
-	{ "^:", KEYMOD_CTRL | KEY_COLON },
-	{ "^,", KEYMOD_CTRL | KEY_COMMA },
-	{ "^-", KEYMOD_CTRL | KEY_MINUS },
-	{ "^.", KEYMOD_CTRL | KEY_PERIOD },
-	{ "^/", KEYMOD_CTRL | KEY_SLASH },
-	{ "^0", KEYMOD_CTRL | KEY_0 },
-	{ "^1", KEYMOD_CTRL | KEY_1 },
-	{ "^2", KEYMOD_CTRL | KEY_2 },
-	{ "^3", KEYMOD_CTRL | KEY_3 },
-	{ "^4", KEYMOD_CTRL | KEY_4 },
-	{ "^5", KEYMOD_CTRL | KEY_5 },
-	{ "^6", KEYMOD_CTRL | KEY_6 },
-	{ "^7", KEYMOD_CTRL | KEY_7 },
-	{ "^8", KEYMOD_CTRL | KEY_8 },
-	{ "^9", KEYMOD_CTRL | KEY_9 },
-	{ "^;", KEYMOD_CTRL | KEY_SEMICOLON },
-	{ "^^", KEYMOD_CTRL | KEY_HAT },
-	{ "^@", KEYMOD_CTRL | KEY_AT },
-	{ "^]", KEYMOD_CTRL | KEY_RIGHTBRACKET },
-	{ "^[", KEYMOD_CTRL | KEY_LEFTBRACKET },
-	{ "^`", KEYMOD_CTRL | KEY_BACKQUOTE },
-	{ "^a", KEYMOD_CTRL | KEY_A },
-	{ "^b", KEYMOD_CTRL | KEY_B },
-	{ "^c", KEYMOD_CTRL | KEY_C },
-	{ "^d", KEYMOD_CTRL | KEY_D },
-	{ "^e", KEYMOD_CTRL | KEY_E },
-	{ "^f", KEYMOD_CTRL | KEY_F },
-	{ "^g", KEYMOD_CTRL | KEY_G },
-	{ "^h", KEYMOD_CTRL | KEY_H },
-	{ "^i", KEYMOD_CTRL | KEY_I },
-	{ "^j", KEYMOD_CTRL | KEY_J },
-	{ "^k", KEYMOD_CTRL | KEY_K },
-	{ "^l", KEYMOD_CTRL | KEY_L },
-	{ "^m", KEYMOD_CTRL | KEY_M },
-	{ "^n", KEYMOD_CTRL | KEY_N },
-	{ "^o", KEYMOD_CTRL | KEY_O },
-	{ "^p", KEYMOD_CTRL | KEY_P },
-	{ "^q", KEYMOD_CTRL | KEY_Q },
-	{ "^r", KEYMOD_CTRL | KEY_R },
-	{ "^s", KEYMOD_CTRL | KEY_S },
-	{ "^t", KEYMOD_CTRL | KEY_T },
-	{ "^u", KEYMOD_CTRL | KEY_U },
-	{ "^v", KEYMOD_CTRL | KEY_V },
-	{ "^w", KEYMOD_CTRL | KEY_W },
-	{ "^x", KEYMOD_CTRL | KEY_X },
-	{ "^y", KEYMOD_CTRL | KEY_Y },
-	{ "^z", KEYMOD_CTRL | KEY_Z },
-	{ "^delete", KEYMOD_CTRL | KEY_DELETE },
-	{ "^n0", KEYMOD_CTRL | KEY_KP0 },
-	{ "^n1", KEYMOD_CTRL | KEY_KP1 },
-	{ "^n2", KEYMOD_CTRL | KEY_KP2 },
-	{ "^n3", KEYMOD_CTRL | KEY_KP3 },
-	{ "^n4", KEYMOD_CTRL | KEY_KP4 },
-	{ "^n5", KEYMOD_CTRL | KEY_KP5 },
-	{ "^n6", KEYMOD_CTRL | KEY_KP6 },
-	{ "^n7", KEYMOD_CTRL | KEY_KP7 },
-	{ "^n8", KEYMOD_CTRL | KEY_KP8 },
-	{ "^n9", KEYMOD_CTRL | KEY_KP9 },
-	{ "^n.", KEYMOD_CTRL | KEY_KP_PERIOD },
-	{ "^n/", KEYMOD_CTRL | KEY_KP_DIVIDE },
-	{ "^n*", KEYMOD_CTRL | KEY_KP_MULTIPLY },
-	{ "^n-", KEYMOD_CTRL | KEY_KP_MINUS },
-	{ "^n+", KEYMOD_CTRL | KEY_KP_PLUS },
-	{ "^nreturn", KEYMOD_CTRL | KEY_KP_ENTER },
-	{ "^nenter", KEYMOD_CTRL | KEY_KP_ENTER },
-	{ "^n=", KEYMOD_CTRL | KEY_KP_EQUALS },
-	{ "^up", KEYMOD_CTRL | KEY_UP },
-	{ "^down", KEYMOD_CTRL | KEY_DOWN },
-	{ "^right", KEYMOD_CTRL | KEY_RIGHT },
-	{ "^left", KEYMOD_CTRL | KEY_LEFT },
-	{ "^insert", KEYMOD_CTRL | KEY_INSERT },
-	{ "^home", KEYMOD_CTRL | KEY_HOME },
-	{ "^end", KEYMOD_CTRL | KEY_END },
-	{ "^pageup", KEYMOD_CTRL | KEY_PAGEUP },
-	{ "^pagedown", KEYMOD_CTRL | KEY_PAGEDOWN  },
-	{ "^f1", KEYMOD_CTRL | KEY_F1 },
-	{ "^f2", KEYMOD_CTRL | KEY_F2 },
-	{ "^f3", KEYMOD_CTRL | KEY_F3 },
-	{ "^f4", KEYMOD_CTRL | KEY_F4 },
-	{ "^f5", KEYMOD_CTRL | KEY_F5 },
-	{ "^f6", KEYMOD_CTRL | KEY_F6 },
-	{ "^f7", KEYMOD_CTRL | KEY_F7 },
-	{ "^f8", KEYMOD_CTRL | KEY_F8 },
-	{ "^f9", KEYMOD_CTRL | KEY_F9 },
-	{ "^f10", KEYMOD_CTRL | KEY_F10 },
-	{ "^f11", KEYMOD_CTRL | KEY_F11 },
-	{ "^f12", KEYMOD_CTRL | KEY_F12 },
-	{ "^f13", KEYMOD_CTRL | KEY_F13 },
-	{ "^f14", KEYMOD_CTRL | KEY_F14 },
-	{ "^f15", KEYMOD_CTRL | KEY_F15 },
-	{ "^numlock", KEYMOD_CTRL | KEY_NUMLOCK },
-	{ "^capslock", KEYMOD_CTRL | KEY_CAPSLOCK },
-	{ "^scrolllock", KEYMOD_CTRL | KEY_SCROLLOCK },
-	{ "^mode", KEYMOD_CTRL | KEY_MODE },
-	{ "^compose", KEYMOD_CTRL | KEY_COMPOSE },
-	{ "^help", KEYMOD_CTRL | KEY_HELP },
-	{ "^print", KEYMOD_CTRL | KEY_PRINT },
-	{ "^sysreq", KEYMOD_CTRL | KEY_SYSREQ },
-	{ "^break", KEYMOD_CTRL | KEY_BREAK },
-	{ "^menu", KEYMOD_CTRL | KEY_MENU },
-	{ "^power", KEYMOD_CTRL | KEY_POWER },
-	{ "^_", KEYMOD_CTRL | KEY_UNDERSCORE },
-	{ "^kana", KEYMOD_CTRL | KEY_KANA },
-	{ "^\\", KEYMOD_CTRL | KEY_YEN  },
-	{ "^xfer", KEYMOD_CTRL | KEY_XFER },
-	{ "^nfer", KEYMOD_CTRL | KEY_NFER },
-	{ "^non-us-backslash", KEYMOD_CTRL | KEY_NONUSBACKSLASH },
-	{ "+backspace", KEYMOD_SHIFT | KEY_BACKSPACE },
-	{ "+tab", KEYMOD_SHIFT | KEY_TAB },
-	{ "+clear", KEYMOD_SHIFT | KEY_CLEAR },
-	{ "+return", KEYMOD_SHIFT | KEY_RETURN },
-	{ "+enter", KEYMOD_SHIFT | KEY_RETURN },
-	{ "+pause", KEYMOD_SHIFT | KEY_PAUSE },
-	{ "+escape", KEYMOD_SHIFT | KEY_ESCAPE },
-	{ "+space", KEYMOD_SHIFT | KEY_SPACE },
-	{ "+:", KEYMOD_SHIFT | KEY_COLON },
-	{ "+,", KEYMOD_SHIFT | KEY_COMMA },
-	{ "+-", KEYMOD_SHIFT | KEY_MINUS },
-	{ "+.", KEYMOD_SHIFT | KEY_PERIOD },
-	{ "+/", KEYMOD_SHIFT | KEY_SLASH },
-	{ "+0", KEYMOD_SHIFT | KEY_0 },
-	{ "+1", KEYMOD_SHIFT | KEY_1 },
-	{ "+2", KEYMOD_SHIFT | KEY_2 },
-	{ "+3", KEYMOD_SHIFT | KEY_3 },
-	{ "+4", KEYMOD_SHIFT | KEY_4 },
-	{ "+5", KEYMOD_SHIFT | KEY_5 },
-	{ "+6", KEYMOD_SHIFT | KEY_6 },
-	{ "+7", KEYMOD_SHIFT | KEY_7 },
-	{ "+8", KEYMOD_SHIFT | KEY_8 },
-	{ "+9", KEYMOD_SHIFT | KEY_9 },
-	{ "+;", KEYMOD_SHIFT | KEY_SEMICOLON },
-	{ "+^", KEYMOD_SHIFT | KEY_HAT },
-	{ "+@", KEYMOD_SHIFT | KEY_AT },
-	{ "+]", KEYMOD_SHIFT | KEY_RIGHTBRACKET },
-	{ "+[", KEYMOD_SHIFT | KEY_LEFTBRACKET },
-	{ "+`", KEYMOD_SHIFT | KEY_BACKQUOTE },
-	{ "+a", KEYMOD_SHIFT | KEY_A },
-	{ "+b", KEYMOD_SHIFT | KEY_B },
-	{ "+c", KEYMOD_SHIFT | KEY_C },
-	{ "+d", KEYMOD_SHIFT | KEY_D },
-	{ "+e", KEYMOD_SHIFT | KEY_E },
-	{ "+f", KEYMOD_SHIFT | KEY_F },
-	{ "+g", KEYMOD_SHIFT | KEY_G },
-	{ "+h", KEYMOD_SHIFT | KEY_H },
-	{ "+i", KEYMOD_SHIFT | KEY_I },
-	{ "+j", KEYMOD_SHIFT | KEY_J },
-	{ "+k", KEYMOD_SHIFT | KEY_K },
-	{ "+l", KEYMOD_SHIFT | KEY_L },
-	{ "+m", KEYMOD_SHIFT | KEY_M },
-	{ "+n", KEYMOD_SHIFT | KEY_N },
-	{ "+o", KEYMOD_SHIFT | KEY_O },
-	{ "+p", KEYMOD_SHIFT | KEY_P },
-	{ "+q", KEYMOD_SHIFT | KEY_Q },
-	{ "+r", KEYMOD_SHIFT | KEY_R },
-	{ "+s", KEYMOD_SHIFT | KEY_S },
-	{ "+t", KEYMOD_SHIFT | KEY_T },
-	{ "+u", KEYMOD_SHIFT | KEY_U },
-	{ "+v", KEYMOD_SHIFT | KEY_V },
-	{ "+w", KEYMOD_SHIFT | KEY_W },
-	{ "+x", KEYMOD_SHIFT | KEY_X },
-	{ "+y", KEYMOD_SHIFT | KEY_Y },
-	{ "+z", KEYMOD_SHIFT | KEY_Z },
-	{ "+delete", KEYMOD_SHIFT | KEY_DELETE },
-	{ "+n0", KEYMOD_SHIFT | KEY_KP0 },
-	{ "+n1", KEYMOD_SHIFT | KEY_KP1 },
-	{ "+n2", KEYMOD_SHIFT | KEY_KP2 },
-	{ "+n3", KEYMOD_SHIFT | KEY_KP3 },
-	{ "+n4", KEYMOD_SHIFT | KEY_KP4 },
-	{ "+n5", KEYMOD_SHIFT | KEY_KP5 },
-	{ "+n6", KEYMOD_SHIFT | KEY_KP6 },
-	{ "+n7", KEYMOD_SHIFT | KEY_KP7 },
-	{ "+n8", KEYMOD_SHIFT | KEY_KP8 },
-	{ "+n9", KEYMOD_SHIFT | KEY_KP9 },
-	{ "+n.", KEYMOD_SHIFT | KEY_KP_PERIOD },
-	{ "+n/", KEYMOD_SHIFT | KEY_KP_DIVIDE },
-	{ "+n*", KEYMOD_SHIFT | KEY_KP_MULTIPLY },
-	{ "+n-", KEYMOD_SHIFT | KEY_KP_MINUS },
-	{ "+n+", KEYMOD_SHIFT | KEY_KP_PLUS },
-	{ "+nreturn", KEYMOD_SHIFT | KEY_KP_ENTER },
-	{ "+nenter", KEYMOD_SHIFT | KEY_KP_ENTER },
-	{ "+n=", KEYMOD_SHIFT | KEY_KP_EQUALS },
-	{ "+up", KEYMOD_SHIFT | KEY_UP },
-	{ "+down", KEYMOD_SHIFT | KEY_DOWN },
-	{ "+right", KEYMOD_SHIFT | KEY_RIGHT },
-	{ "+left", KEYMOD_SHIFT | KEY_LEFT },
-	{ "+insert", KEYMOD_SHIFT | KEY_INSERT },
-	{ "+home", KEYMOD_SHIFT | KEY_HOME },
-	{ "+end", KEYMOD_SHIFT | KEY_END },
-	{ "+pageup", KEYMOD_SHIFT | KEY_PAGEUP },
-	{ "+pagedown", KEYMOD_SHIFT | KEY_PAGEDOWN  },
-	{ "+f1", KEYMOD_SHIFT | KEY_F1 },
-	{ "+f2", KEYMOD_SHIFT | KEY_F2 },
-	{ "+f3", KEYMOD_SHIFT | KEY_F3 },
-	{ "+f4", KEYMOD_SHIFT | KEY_F4 },
-	{ "+f5", KEYMOD_SHIFT | KEY_F5 },
-	{ "+f6", KEYMOD_SHIFT | KEY_F6 },
-	{ "+f7", KEYMOD_SHIFT | KEY_F7 },
-	{ "+f8", KEYMOD_SHIFT | KEY_F8 },
-	{ "+f9", KEYMOD_SHIFT | KEY_F9 },
-	{ "+f10", KEYMOD_SHIFT | KEY_F10 },
-	{ "+f11", KEYMOD_SHIFT | KEY_F11 },
-	{ "+f12", KEYMOD_SHIFT | KEY_F12 },
-	{ "+f13", KEYMOD_SHIFT | KEY_F13 },
-	{ "+f14", KEYMOD_SHIFT | KEY_F14 },
-	{ "+f15", KEYMOD_SHIFT | KEY_F15 },
-	{ "+numlock", KEYMOD_SHIFT | KEY_NUMLOCK },
-	{ "+capslock", KEYMOD_SHIFT | KEY_CAPSLOCK },
-	{ "+scrolllock", KEYMOD_SHIFT | KEY_SCROLLOCK },
-	{ "+mode", KEYMOD_SHIFT | KEY_MODE },
-	{ "+compose", KEYMOD_SHIFT | KEY_COMPOSE },
-	{ "+help", KEYMOD_SHIFT | KEY_HELP },
-	{ "+print", KEYMOD_SHIFT | KEY_PRINT },
-	{ "+sysreq", KEYMOD_SHIFT | KEY_SYSREQ },
-	{ "+break", KEYMOD_SHIFT | KEY_BREAK },
-	{ "+menu", KEYMOD_SHIFT | KEY_MENU },
-	{ "+power", KEYMOD_SHIFT | KEY_POWER },
-	{ "+_", KEYMOD_SHIFT | KEY_UNDERSCORE },
-	{ "+kana", KEYMOD_SHIFT | KEY_KANA },
-	{ "+\\", KEYMOD_SHIFT | KEY_YEN  },
-	{ "+xfer", KEYMOD_SHIFT | KEY_XFER },
-	{ "+nfer", KEYMOD_SHIFT | KEY_NFER },
-	{ "+non-us-backslash", KEYMOD_SHIFT | KEY_NONUSBACKSLASH },
-	{ NULL, 0 }
-};
-
 /*
-	TEhobt@𓾂 (init̉)
+	2ׂ̂ɐ؂グ (init̉)
 */
-static int getSoundBufferLength(int *refresh_rate)
+static int roundPow2(int n)
 {
-	int len;
+	int m;
 
-	for(len = 0x40000000; len != 1 && len > AUDIO_RATE / *refresh_rate; len >>= 1)
+	for(m = 1; m < n; m <<= 1)
 		;
-
-	*refresh_rate = AUDIO_RATE / len;
-	return len;
+	return m;
 }
 
 /*
 	G~[^
 */
-int init(Z1stat *z1, int argc, char *argv[])
+int init(Z1stat *z1, const char *config, int argc, char *argv[])
 {
 	Conf conf[256];
 	int ram_size;
-	uint16 key;
-	const OptTable *p;
 
 	memset(z1, 0, sizeof(*z1));
 	z1->cpu.i.user_data = z1;
 	z1->cpu.m = z1->memory;
 	z1->disk.files_p = z1->disk.files = NULL;
+	z1->disk.inotify = -1;
+	z1->run.start = -1;
 
-	if(getConfig(conf, sizeof(conf) / sizeof(conf[0]), "z1f9config", argc, argv) == NULL)
+	if(getConfig(conf, sizeof(conf) / sizeof(conf[0]), config, argc, argv) == NULL)
 		return FALSE;
 
 	/* fobO[h */
@@ -721,6 +273,16 @@ int init(Z1stat *z1, int argc, char *argv[])
 	/* LCD{ */
 	z1->setting.zoom = getOptInt(conf, "zoom", 3);
 
+	/* \ */
+	z1->setting.display = getOptTable(conf, "display", tableDisplay, DISPLAY_SURFACE);
+
+	/* `Xbh */
+	z1->setting.render_thread = getOptYesNo(conf, "render_thread", FALSE);
+
+	/* LCDLv` */
+	z1->setting.capture_format = getOptTable(conf, "capture_format", tableCapture, CAPTURE_NONE);
+	setHomeDir(z1->setting.path_capture, getOptText(conf, "capture_path", "./capture/lcd"));
+
 	/* LCDK */
 	if((z1->setting.scales = getOptInt(conf, "lcd_scales", 2)) == 1)
 		z1->setting.scales = 2;
@@ -733,55 +295,30 @@ int init(Z1stat *z1, int argc, char *argv[])
 	/* VA|[g ͌ */
 	setIOData(&z1->rs_receive, getOptText(conf, "sio_in", "./sio_in.txt"));
 
+	/* VA|[g x */
+	z1->setting.sio_unlimited = getOptYesNo(conf, "sio_unlimited", FALSE);
+
+	/* VA|[g [[ */
+	z1->setting.sio_pty = getOptYesNo(conf, "sio_pty", FALSE);
+	setHomeDir(z1->setting.path_pty_link, getOptText(conf, "sio_pty_link", ""));
+
 	/* v^|[g o͐ */
 	setIOData(&z1->printer, getOptText(conf, "printer", "./print.txt"));
 
 	/* ztbs[fBXN fBNg */
 	strcpy(z1->disk.dir, getOptText(conf, "floppy_dir", "./"));
 
-	/* L[zu */
-	for(p = tableZkey; p->string != NULL; p++) {
-		if(p->value & ~ZKEYMOD_MASK)
-			continue;
-		if((key = getOptTable(conf, p->string, tableKey, 0)) == 0)
-			continue;
-		keyConv[key & ~KEYMOD_MASK] = p->value;
-		keyConvAlt[key & ~KEYMOD_MASK] = p->value;
-		keyConvCtrl[key & ~KEYMOD_MASK] = p->value;
-		keyConvShift[key & ~KEYMOD_MASK] = p->value;
-	}
-
-	for(p = tableZkey; p->string != NULL; p++) {
-		if((key = getOptTable(conf, p->string, tableKey, 0)) == 0)
-			continue;
-		switch(key & KEYMOD_MASK) {
-		case 0:
-			keyConv[key & ~KEYMOD_MASK] = p->value;
-			break;
-		case KEYMOD_ALT:
-			if(p->value & ZKEYMOD_SHIFT)
-				keyConvAlt[key & ~KEYMOD_MASK] = p->value;
-			else
-				keyConvAlt[key & ~KEYMOD_MASK] = (p->value & ~ZKEYMOD_MASK) | ZKEYMOD_NOSHIFT;
-			break;
-		case KEYMOD_CTRL:
-			if(p->value & ZKEYMOD_SHIFT)
-				keyConvCtrl[key & ~KEYMOD_MASK] = p->value;
-			else
-				keyConvCtrl[key & ~KEYMOD_MASK] = (p->value & ~ZKEYMOD_MASK) | ZKEYMOD_NOSHIFT;
-			break;
-		case KEYMOD_SHIFT:
-			if(p->value & ZKEYMOD_SHIFT)
-				keyConvShift[key & ~KEYMOD_MASK] = p->value & ~ZKEYMOD_MASK;
-			else
-				keyConvShift[key & ~KEYMOD_MASK] = (p->value & ~ZKEYMOD_MASK) | ZKEYMOD_NOSHIFT;
-			break;
-		}
-	}
+	/* ztbs[fBXN C[W */
+	setHomeDir(z1->setting.path_floppy_image, getOptText(conf, "floppy_image", ""));
 
 	/* CPUNbNg */
 	z1->setting.cpu_clock = getOptInt(conf, "clock", 3686400);
 
+	/* ͂̑x (l͗]Tl, ROM̃L[ɑ΂đ̂ł͂Ȃ) */
+	z1->setting.auto_key_press = getOptInt(conf, "auto_key_press", 20) * (z1->setting.cpu_clock / 1000);
+	z1->setting.auto_key_release = getOptInt(conf, "auto_key_release", 20) * (z1->setting.cpu_clock / 1000);
+	z1->setting.auto_key_return = getOptInt(conf, "auto_key_return", 300) * (z1->setting.cpu_clock / 1000);
+
 	/* /gRAMe */
 	ram_size = getOptInt(conf, "ram_size", 0) * 0x40;
 	if (ram_size < z1->setting.iram_size)
@@ -798,6 +335,13 @@ int init(Z1stat *z1, int argc, char *argv[])
 	/* I/O XV */
 	z1->setting.refresh_rate = getOptInt(conf, "refresh", 30);
 
+	/* x̒ */
+	z1->setting.pacing = getOptTable(conf, "pacing", tablePacing, PACING_AUDIO);
+
+	/* ^[{ */
+	z1->turbo.on = getOptYesNo(conf, "turbo", FALSE);
+	z1->setting.turbo_limit = MAX(getOptInt(conf, "turbo_limit", 0), 0);
+
 	/* WCXeBbN */
 	z1->joy.right = getOptTable(conf, "joy_right", tableZkey, 0);
 	z1->joy.left = getOptTable(conf, "joy_left", tableZkey, 0);
@@ -821,12 +365,70 @@ int init(Z1stat *z1, int argc, char *argv[])
 	z1->joy.button[15] = getOptTable(conf, "joy_button16", tableZkey, 0);
 
 	/* uU[ */
+	setHomeDir(z1->setting.path_wave, getOptText(conf, "wave_path", ""));
+	if(getOptYesNo(conf, "buzzer", TRUE) || strcmp(z1->setting.path_wave, "") != 0) {
+		z1->sound.mix_len = AUDIO_RATE / z1->setting.refresh_rate * 2 + 16;
+		z1->sound.mix = calloc(z1->sound.mix_len, sizeof(float));
+		z1->sound.pcm = calloc(z1->sound.mix_len, 1);
+	}
 	if(getOptYesNo(conf, "buzzer", TRUE)) {
-		z1->sound.len = getSoundBufferLength(&z1->setting.refresh_rate);
-		z1->sound.buffer[0] = calloc(z1->sound.len, 1);
-		z1->sound.buffer[1] = calloc(z1->sound.len, 1);
+		z1->sound.len = roundPow2(MAX(getOptInt(conf, "audio_samples", 1024), 64));
+		z1->sound.size = roundPow2((z1->sound.len + z1->sound.mix_len) * 4);
+		z1->sound.ring = calloc(z1->sound.size, 1);
+
+		z1->sound.target = getOptInt(conf, "audio_latency", 0) * AUDIO_RATE / 1000;
+		if(z1->sound.target < z1->sound.len + AUDIO_RATE / z1->setting.refresh_rate / 2)
+			z1->sound.target = z1->sound.len + AUDIO_RATE / z1->setting.refresh_rate / 2;
+		if(z1->sound.target > z1->sound.size - z1->sound.mix_len)
+			z1->sound.target = z1->sound.size - z1->sound.mix_len;
+
+		/* foCX̃obt@1̖n߂ */
+		atomic_store(&z1->sound.write, z1->sound.len);
+	}
+
+	if(!initIO(z1))
+		return FALSE;
+	if(strcmp(z1->setting.path_floppy_image, "") != 0 && !openFdImage(&z1->disk, z1->setting.path_floppy_image)) {
+		fprintf(stderr, "CANNOT OPEN FLOPPY IMAGE. (%s)\n", z1->setting.path_floppy_image);
+		return FALSE;
+	}
+	if(!initIOPort(z1))
+		return FALSE;
+	if(!initCapture(z1))
+		return FALSE;
+	return initRecord(z1);
+}
+
+/*
+	G~[^I (initŊmۂ̂)
+*/
+void term(Z1stat *z1)
+{
+	int i;
+
+	stopIOPort(z1);
+	stopCapture(z1);
+	stopRecord(z1);
+	closeDisk(&z1->disk);
+
+	if(z1->rs_receive.in != NULL)
+		fclose(z1->rs_receive.in);
+	z1->rs_receive.in = NULL;
+	for(i = 0; i < 0x100; i++) {
+		free(z1->io[i]);
+		z1->io[i] = NULL;
 	}
-	return initDepend(z1);
+	free(z1->rs_send.kept);
+	free(z1->printer.kept);
+	free(z1->auto_key.event);
+	free(z1->sound.mix);
+	free(z1->sound.pcm);
+	free(z1->sound.ring);
+	z1->rs_send.kept = z1->printer.kept = NULL;
+	z1->auto_key.event = NULL;
+	z1->sound.mix = NULL;
+	z1->sound.pcm = NULL;
+	z1->sound.ring = NULL;
 }
 
 /*
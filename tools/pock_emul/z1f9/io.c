@@ -4,24 +4,17 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
 #include "z1.h"
 
 /*
-	InportG~[g (8bit)
+	Rg[ (8bit)
 */
-uint8 i86inp8(I86stat *i86, uint16 port)
+static uint8 inIntr8(I86stat *i86, uint16 port)
 {
 	Z1stat *z1 = i86->i.user_data;
-	uint32 size;
-	uint16 v;
-	uint8 data, f, a[16];
-
-	/*
-	printf("IO IN %04x\n", port);
-	*/
-	i86->i.op_states += 12;
 
 	switch(port) {
 	case 0x0008: /* }XN */
@@ -81,260 +74,43 @@ uint8 i86inp8(I86stat *i86, uint16 port)
 	case 0x001f:
 		return 0x00;
 
-	case 0x0030: /* ^C}0 JE^ */
-		return getTimerCount(z1, &z1->timer.t0) & 0xff;
-	case 0x0031:
-		return getTimerCount(z1, &z1->timer.t0) >> 8;
-
-	case 0x0032: /* ^C}0 ԊuA */
-		return *LOW(z1->timer.t0.interval_a);
-	case 0x0033:
-		return *HIGH(z1->timer.t0.interval_a);
-
-	case 0x0034: /* ^C}0 ԊuB */
-		return *LOW(z1->timer.t0.interval_b);
-	case 0x0035:
-		return *HIGH(z1->timer.t0.interval_b);
-
-	case 0x0036: /* ^C}0 Rg[ */
-		return *LOW(z1->timer.t0.control);
-	case 0x0037:
-		return *HIGH(z1->timer.t0.control);
-
-	case 0x0038: /* ^C}1 JE^ */
-		return getTimerCount(z1, &z1->timer.t1) & 0xff;
-	case 0x0039:
-		return getTimerCount(z1, &z1->timer.t1) >> 8;
-
-	case 0x003a: /* ^C}1 ԊuA */
-		return *LOW(z1->timer.t1.interval_a);
-	case 0x003b:
-		return *HIGH(z1->timer.t1.interval_a);
-
-	case 0x003c: /* ^C}1 ԊuB */
-		return *LOW(z1->timer.t1.interval_b);
-	case 0x003d:
-		return *HIGH(z1->timer.t1.interval_b);
-
-	case 0x003e: /* ^C}1 Rg[ */
-		return *LOW(z1->timer.t1.control);
-	case 0x003f:
-		return *HIGH(z1->timer.t1.control);
-
-	case 0x0040: /* ^C}2 JE^ */
-		return getTimerCount(z1, &z1->timer.t2) & 0xff;
-	case 0x0041:
-		return getTimerCount(z1, &z1->timer.t2) >> 8;
-
-	case 0x0042: /* ^C}2 ԊuA */
-		return *LOW(z1->timer.t2.interval_a);
-	case 0x0043:
-		return *HIGH(z1->timer.t2.interval_a);
-
-	case 0x0046: /* ^C}2 Rg[ */
-		return *LOW(z1->timer.t2.control);
-	case 0x0047:
-		return *HIGH(z1->timer.t2.control);
-
-	case 0x005a: /* obe[e */
-		return 0x04 | z1->setting.machine;
-	case 0x005b:
-		return 0x00;
-
-	case 0x0060: /* VA|[g {[[g */
-		return *LOW(z1->sio.baud);
-	case 0x0061:
-		return *HIGH(z1->sio.baud);
-
-	case 0x0064: /* VA|[g ݒ */
-		return *LOW(z1->sio.settings);
-	case 0x0065:
-		return *HIGH(z1->sio.settings);
-
-	case 0x0066: /* VA|[g Xe[^X */
-		return 0x08;
-	case 0x0067:
-		return 0x00;
-
-	case 0x0068: /* VA|[g M */
-		receiveIOData(&z1->rs_receive, &data);
-		return data;
-	case 0x0069:
-		return 0x00;
-
-	case 0x0082: /* RAMe */
-		return *LOW(z1->setting.iram_size);
-	case 0x0083:
-		return *HIGH(z1->setting.iram_size);
-
-	case 0x0086: /* gRAMe */
-		return *LOW(z1->setting.oram_size);
-	case 0x0087:
-		return *HIGH(z1->setting.oram_size);
-
-	case 0x00a2: /* ??? */
-		return 0x0a;
-	case 0x00a3:
-		return 0x80;
-
-	case 0x00a6: /* ??? */
-		return 0xce;
-	case 0x00a7:
-		return 0xff;
-
-	case 0x00b8: /* dRg[ */
-		return *LOW(z1->power);
-	case 0x00b9:
-		return *HIGH(z1->power);
-
-	case 0x0202: /* L[ */
-	case 0x0203:
-		/*i86->i.op_states += 24;*/
-		v =
-		(z1->key.strobe & 0x0001 ? z1->key.matrix[0]: 0) |
-		(z1->key.strobe & 0x0002 ? z1->key.matrix[1]: 0) |
-		(z1->key.strobe & 0x0004 ? z1->key.matrix[2]: 0) |
-		(z1->key.strobe & 0x0008 ? z1->key.matrix[3]: 0) |
-		(z1->key.strobe & 0x0010 ? z1->key.matrix[4]: 0) |
-		(z1->key.strobe & 0x0020 ? z1->key.matrix[5]: 0) |
-		(z1->key.strobe & 0x0040 ? z1->key.matrix[6]: 0) |
-		(z1->key.strobe & 0x0080 ? z1->key.matrix[7]: 0) |
-		(z1->key.strobe & 0x0100 ? z1->key.matrix[8]: 0) |
-		(z1->key.strobe & 0x0200 ? z1->key.matrix[9]: 0) |
-		(z1->key.strobe & 0x0400 ? z1->key.matrix[10]: 0) |
-		z1->key.matrix[11];
-		if(!v)
-			v = 0x8000;
-		return (port == 0x0202 ? v & 0xff: v >> 8);
-
-	case 0x0204: /* L[Rg[ */
-		return 0x04;
-	case 0x0205:
-		return 0x00;
-
-	case 0x0220: /* Z */
-		opXY(z1->cal.op, &i86->m[0x0400], &i86->m[0x0410], a, &f);
-		return f;
-	case 0x0221:
-		return 0x00;
-
-	case 0x0240: /* VAEp|[g Xe[^X */
-		return 0x00;
-	case 0x0241:
-		/* DTR RTS INIT STB CTR DSR CD BUSY */
-		return 0xfe;
-
-	case 0x0274: /* ??? */
-		return 0x76;
-	case 0x0275:
-		return 0x75;
-
-	case 0x02a6: /* FDD */
-		/*  */
-		/*printf("FDD DATA? CMD=%02x, COUNT=%d, DATA=%02x, ERR=%02x\n", z1->fdd.cmd, z1->disk.result_count, z1->disk.data, z1->fdd.err);*/
-		switch(z1->fdd.cmd) {
-		case 0x03: /* t@C */
-			z1->fdd.err = getFoundFdFile(&z1->disk, &z1->disk.data);
-			return z1->disk.data;
-		default:
-			return z1->disk.data;
-		}
-	case 0x02a7:
-		/* s 01:G[, 02:R}h, 04:R}hJn, 08:R}h튮, 10:foCX */
-		if(z1->disk.result_count < 0)
-			return 0x1e;
-		/*printf("FDD STAT? CMD=%02x, PARAM=%s, LEN=%d, COUNT=%d, ERR=%02x\n", z1->fdd.cmd, z1->fdd.param, (int )(z1->fdd.param_p - z1->fdd.param), z1->disk.result_count, z1->fdd.err);*/
-
-		switch(z1->fdd.cmd) {
-		case 0x10: /* fBXN󂫗e */
-			z1->fdd.err = getFdFreeSize(&z1->disk, &size);
-
-			if(z1->disk.result_count == 0)
-				z1->disk.data = z1->fdd.err;
-			else if(z1->disk.result_count == 1)
-				z1->disk.data = size & 0xff;
-			else if(z1->disk.result_count == 2)
-				z1->disk.data = (size >> 8) & 0xff;
-			else if(z1->disk.result_count == 3)
-				z1->disk.data = (size >> 16) & 0xff;
-			else if(z1->disk.result_count == 4)
-				z1->disk.data = (size >> 24) & 0xff;
-			else
-				z1->disk.data = 0x00;
-			break;
-		case 0x12: /* t@C */
-			if(z1->disk.result_count == 0)
-				z1->disk.data = z1->fdd.err = 0x00;
-			else if(z1->disk.result_count == 1)
-				z1->fdd.err = findFdFile(&z1->disk, &z1->fdd.param[0], &z1->disk.data);
-			else if(z1->disk.result_count == 2)
-				z1->disk.data = 0x00;
-			else if(z1->disk.result_count == 3)
-				z1->disk.data = 0x00;
-			break;
-		case 0x13: /* t@CꊇǍI[v */
-			if(z1->disk.result_count == 0)
-				z1->disk.data = z1->fdd.err;
-			else if(z1->disk.result_count == 1)
-				z1->disk.data = z1->disk.size & 0xff;
-			else if(z1->disk.result_count == 2)
-				z1->disk.data = (z1->disk.size >> 8) & 0xff;
-			else if(z1->disk.result_count == 3)
-				z1->disk.data = (z1->disk.size >> 16) & 0xff;
-			else if(z1->disk.result_count == 4)
-				z1->disk.data = (z1->disk.size >> 24) & 0xff;
-			else if(z1->disk.result_count < 4 + z1->disk.size)
-				z1->fdd.err = readFdFile(&z1->disk, &z1->disk.data);
-			else
-				z1->disk.data = 0x00;
-			break;
-		case 0x1b: /* t@CǍ/ */
-			if(z1->disk.result_count == 0)
-				z1->disk.data = z1->fdd.err;
-			else if(z1->disk.result_count == 1)
-				*LOW(z1->disk.len) = z1->disk.data = z1->disk.size - z1->disk.pos >= 0x100 ? 0x00: z1->disk.size - z1->disk.pos;
-			else if(z1->disk.result_count == 2)
-				*HIGH(z1->disk.len) = z1->disk.data = z1->disk.size - z1->disk.pos >= 0x100 ? 0x01: 0x00;
-			else if(z1->disk.result_count < 3 + MIN(z1->disk.len, 256))
-				z1->fdd.err = readFdFile(&z1->disk, &z1->disk.data);
-			else
-				z1->disk.data = 0x00;
-			break;
-		default:
-			if(z1->disk.result_count == 0)
-				z1->disk.data = z1->fdd.err;
-			else
-				z1->disk.data = 0x00;
-			break;
-		}
-		z1->disk.result_count++;
-		return (z1->fdd.err ? 0x01: 0x1e);
-
 	default:
-		/*printf("IO IN %04x\n", port);*/
-		return 0;
+		return 0x00;
 	}
 }
 
 /*
-	InportG~[g (16bit)
+	Rg[ (16bit)
 */
-uint16 i86inp16(I86stat *i86, uint16 port)
+static uint16 inIntr16(I86stat *i86, uint16 port)
 {
-	return ((uint16 )i86inp8(i86, port + 1) << 8) | i86inp8(i86, port);
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
+	case 0x0012: /* ^C} Rg[ */
+		return z1->timer.control;
+	case 0x0014: /* VA|[g Rg[ */
+		return z1->sio.control;
+	case 0x0016: /* O4(J[hGbW) Rg[ */
+		return z1->card.control;
+	case 0x0018: /* O0(L[) Rg[ */
+		return z1->key.control;
+	case 0x001a: /* O1(dXCb`) Rg[ */
+		return z1->sw.control;
+	case 0x001c: /* O2 Rg[ */
+	case 0x001e: /* O3 Rg[ */
+		return 0x000f;
+	default:
+		return ((uint16 )inIntr8(i86, port + 1) << 8) | inIntr8(i86, port);
+	}
 }
 
 /*
-	OutportG~[g (8bit)
+	Rg[ (8bito)
 */
-int i86out8(I86stat *i86, uint16 port, uint8 x)
+static int outIntr8(I86stat *i86, uint16 port, uint8 x)
 {
 	Z1stat *z1 = i86->i.user_data;
-	uint8 f, a[16];
-
-	/*printf("OUT8  %04x,%02x\n", port, x);*/
-
-	i86->i.op_states += 12;
 
 	switch(port) {
 	case 0x0002: /* I */
@@ -419,109 +195,238 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 		*HIGH(z1->sw.control) = 0;
 		return FALSE;
 
-	case 0x001c: /* O2 Rg[ */
-		return FALSE;
-	case 0x001d:
+	default: /* O2, 3 Rg[ */
 		return FALSE;
+	}
+}
 
-	case 0x001e: /* O3 Rg[ */
+/*
+	Rg[ (16bito)
+*/
+static int outIntr16(I86stat *i86, uint16 port, uint16 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+	int result;
+
+	switch(port) {
+	case 0x0012: /* ^C} Rg[ */
+		z1->timer.control = x & 0x000f;
+		return TRUE;
+	case 0x0014: /* VA|[g Rg[ */
+		z1->sio.control = x & 0x000f;
 		return FALSE;
-	case 0x001f:
+	case 0x0016: /* O4(J[hGbW) Rg[ */
+		z1->card.control = x & 0x007f;
+		return FALSE;
+	case 0x0018: /* O0(L[) Rg[ */
+		z1->key.control = x & 0x007f;
+		return FALSE;
+	case 0x001a: /* O1(dXCb`) Rg[ */
+		z1->sw.control = x & 0x007f;
+		return FALSE;
+	case 0x001c: /* O2 Rg[ */
+	case 0x001e: /* O3 Rg[ */
 		return FALSE;
+	default:
+		result = outIntr8(i86, port, x & 0xff);
+		result |= outIntr8(i86, port + 1, x >> 8);
+		return result;
+	}
+}
 
-	case 0x0030: /* ^C}0 JE^ */
-		setTimerCount(z1, &z1->timer.t0, (getTimerCount(z1, &z1->timer.t0) & 0xff00) | x);
-		return TRUE;
-	case 0x0031:
-		setTimerCount(z1, &z1->timer.t0, (getTimerCount(z1, &z1->timer.t0) & 0x00ff) | ((int )x << 8));
-		return TRUE;
+/*
+	|[gɑΉ^C}𓾂 (^C}̉)
+*/
+static struct Timer *getTimer(Z1stat *z1, uint16 port)
+{
+	switch(port & ~0x0007) {
+	case 0x0030:
+		return &z1->timer.t0;
+	case 0x0038:
+		return &z1->timer.t1;
+	default:
+		return &z1->timer.t2;
+	}
+}
 
-	case 0x0032: /* ^C}0 ԊuA */
-		*LOW(z1->timer.t0.interval_a) = x;
-		/*setTimerCount(z1, &z1->timer.t0, 0);*/
-		return TRUE;
-	case 0x0033:
-		*HIGH(z1->timer.t0.interval_a) = x;
-		/*setTimerCount(z1, &z1->timer.t0, 0);*/
-		return TRUE;
+/*
+	^C}̃Rg[̗Lȃrbg𓾂 (^C}̉)
+*/
+static uint16 getTimerControlMask(uint16 port)
+{
+	return ((port & ~0x0007) == 0x0040 ? 0xa021: 0xb03f);
+}
 
-	case 0x0034: /* ^C}0 ԊuB */
-		*LOW(z1->timer.t0.interval_b) = x;
-		/*setTimerCount(z1, &z1->timer.t0, 0);*/
-		return TRUE;
-	case 0x0035:
-		*HIGH(z1->timer.t0.interval_b) = x;
-		/*setTimerCount(z1, &z1->timer.t0, 0);*/
-		return TRUE;
+/*
+	^C} (8bit)
+*/
+static uint8 inTimer8(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+	struct Timer *t = getTimer(z1, port);
 
-	case 0x0036: /* ^C}0 Rg[ */
-		*LOW(z1->timer.t0.control) = x & 0x3f;
-		return TRUE;
-	case 0x0037:
-		*HIGH(z1->timer.t0.control) = x & 0xb0;
-		if(z1->timer.t0.control & 0x8000)
-			setTimerCount(z1, &z1->timer.t0, 0);
-		return TRUE;
+	switch(port & 0x0007) {
+	case 0x0000: /* JE^ */
+		return getTimerCount(z1, t) & 0xff;
+	case 0x0001:
+		return getTimerCount(z1, t) >> 8;
 
-	case 0x0038: /* ^C}1 JE^ */
-		setTimerCount(z1, &z1->timer.t1, (getTimerCount(z1, &z1->timer.t1) & 0xff00) | x);
-		return TRUE;
-	case 0x0039:
-		setTimerCount(z1, &z1->timer.t1, (getTimerCount(z1, &z1->timer.t1) & 0x00ff) | ((int )x << 8));
-		return TRUE;
+	case 0x0002: /* ԊuA */
+		return *LOW(t->interval_a);
+	case 0x0003:
+		return *HIGH(t->interval_a);
+
+	case 0x0004: /* ԊuB */
+		return *LOW(t->interval_b);
+	case 0x0005:
+		return *HIGH(t->interval_b);
 
-	case 0x003a: /* ^C}1 ԊuA */
-		*LOW(z1->timer.t1.interval_a) = x;
-		/*setTimerCount(z1, &z1->timer.t1, 0);*/
+	case 0x0006: /* Rg[ */
+		return *LOW(t->control);
+	default:
+		return *HIGH(t->control);
+	}
+}
+
+/*
+	^C} (16bit)
+*/
+static uint16 inTimer16(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+	struct Timer *t = getTimer(z1, port);
+
+	switch(port & 0x0007) {
+	case 0x0000: /* JE^ */
+		return getTimerCount(z1, t);
+	case 0x0002: /* ԊuA */
+		return t->interval_a;
+	case 0x0004: /* ԊuB */
+		return t->interval_b;
+	case 0x0006: /* Rg[ */
+		return t->control;
+	default:
+		return ((uint16 )inTimer8(i86, port + 1) << 8) | inTimer8(i86, port);
+	}
+}
+
+/*
+	^C} (8bito)
+*/
+static int outTimer8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+	struct Timer *t = getTimer(z1, port);
+
+	switch(port & 0x0007) {
+	case 0x0000: /* JE^ */
+		setTimerCount(z1, t, (getTimerCount(z1, t) & 0xff00) | x);
 		return TRUE;
-	case 0x003b:
-		*HIGH(z1->timer.t1.interval_a) = x;
-		/*setTimerCount(z1, &z1->timer.t1, 0);*/
+	case 0x0001:
+		setTimerCount(z1, t, (getTimerCount(z1, t) & 0x00ff) | ((int )x << 8));
 		return TRUE;
 
-	case 0x003c: /* ^C}1 ԊuB */
-		*LOW(z1->timer.t1.interval_b) = x;
-		/*setTimerCount(z1, &z1->timer.t1, 0);*/
+	case 0x0002: /* ԊuA */
+		*LOW(t->interval_a) = x;
+		/*setTimerCount(z1, t, 0);*/
 		return TRUE;
-	case 0x003d:
-		*HIGH(z1->timer.t1.interval_b) = x;
-		/*setTimerCount(z1, &z1->timer.t1, 0);*/
+	case 0x0003:
+		*HIGH(t->interval_a) = x;
+		/*setTimerCount(z1, t, 0);*/
 		return TRUE;
 
-	case 0x003e: /* ^C}1 Rg[ */
-		*LOW(z1->timer.t1.control) = x & 0x3f;
+	case 0x0004: /* ԊuB */
+		*LOW(t->interval_b) = x;
+		/*setTimerCount(z1, t, 0);*/
 		return TRUE;
-	case 0x003f:
-		*HIGH(z1->timer.t1.control) = x & 0xb0;
-		if(z1->timer.t1.control & 0x8000)
-			setTimerCount(z1, &z1->timer.t1, 0);
+	case 0x0005:
+		*HIGH(t->interval_b) = x;
+		/*setTimerCount(z1, t, 0);*/
 		return TRUE;
 
-	case 0x0040: /* ^C}2 JE^ */
-		setTimerCount(z1, &z1->timer.t2, (getTimerCount(z1, &z1->timer.t2) & 0xff00) | x);
+	case 0x0006: /* Rg[ */
+		*LOW(t->control) = x & getTimerControlMask(port);
 		return TRUE;
-	case 0x0041:
-		setTimerCount(z1, &z1->timer.t2, (getTimerCount(z1, &z1->timer.t2) & 0x00ff) | ((int )x << 8));
+	default:
+		*HIGH(t->control) = x & (getTimerControlMask(port) >> 8);
+		if(t->control & 0x8000)
+			setTimerCount(z1, t, 0);
 		return TRUE;
+	}
+}
+
+/*
+	^C} (16bito)
+*/
+static int outTimer16(I86stat *i86, uint16 port, uint16 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+	struct Timer *t = getTimer(z1, port);
+	int result;
 
-	case 0x0042: /* ^C}2 ԊuA */
-		*LOW(z1->timer.t2.interval_a) = x;
-		/*setTimerCount(z1, &z1->timer.t2, 0);*/
+	switch(port & 0x0007) {
+	case 0x0000: /* JE^ */
+		setTimerCount(z1, t, x);
 		return TRUE;
-	case 0x0043:
-		*HIGH(z1->timer.t2.interval_a) = x;
-		/*setTimerCount(z1, &z1->timer.t2, 0);*/
+	case 0x0002: /* ԊuA */
+		t->interval_a = x;
 		return TRUE;
-
-	case 0x0046: /* ^C}2 Rg[ */
-		*LOW(z1->timer.t2.control) = x & 0x21;
+	case 0x0004: /* ԊuB */
+		t->interval_b = x;
 		return TRUE;
-	case 0x0047:
-		*HIGH(z1->timer.t2.control) = x & 0xa0;
-		if(z1->timer.t2.control & 0x8000)
-			setTimerCount(z1, &z1->timer.t2, 0);
+	case 0x0006: /* Rg[ */
+		t->control = x & getTimerControlMask(port);
+		if(t->control & 0x8000)
+			setTimerCount(z1, t, 0);
 		return TRUE;
+	default:
+		result = outTimer8(i86, port, x & 0xff);
+		result |= outTimer8(i86, port + 1, x >> 8);
+		return result;
+	}
+}
 
+/*
+	VA|[g (8bit)
+*/
+static uint8 inSio8(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
+	case 0x0060: /* VA|[g {[[g */
+		return *LOW(z1->sio.baud);
+	case 0x0061:
+		return *HIGH(z1->sio.baud);
+
+	case 0x0064: /* VA|[g ݒ */
+		return *LOW(z1->sio.settings);
+	case 0x0065:
+		return *HIGH(z1->sio.settings);
+
+	case 0x0066: /* VA|[g Xe[^X */
+		return getUARTStatus(z1);
+	case 0x0067:
+		return 0x00;
+
+	case 0x0068: /* VA|[g M */
+		return readUART(z1);
+	case 0x0069:
+		return 0x00;
+
+	default:
+		return 0x00;
+	}
+}
+
+/*
+	VA|[g (8bito)
+*/
+static int outSio8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
 	case 0x0060: /* VA|[g {[[g */
 		*LOW(z1->sio.baud) = x;
 		/*printf("clock=%d, baud=%04x\n", z1->sio.baud & 0x8000 ? 1: 0, z1->sio.baud & 0x7fff);*/
@@ -558,28 +463,211 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 		*/
 		return FALSE;
 
-	case 0x006a: /* VA|[g M */
-		/*printf("COM SEND %c(%02x)\n", x, x);*/
-		sendIOData(&z1->rs_send, x);
-		z1->sio.sent = TRUE;
-		return TRUE;
-	case 0x006b:
-		return FALSE;
+	case 0x006a: /* VA|[g M */
+		/*printf("COM SEND %c(%02x)\n", x, x);*/
+		writeUART(z1, x);
+		return TRUE;
+	case 0x006b:
+		return FALSE;
+
+	default:
+		return FALSE;
+	}
+}
+
+/*
+	VAEp|[g (8bit)
+*/
+static uint8 inPrn8(I86stat *i86, uint16 port)
+{
+	switch(port) {
+	case 0x0240: /* VAEp|[g Xe[^X */
+		return 0x00;
+	case 0x0241:
+		/* DTR RTS INIT STB CTR DSR CD BUSY */
+		return 0xfe;
+
+	default:
+		return 0x00;
+	}
+}
+
+/*
+	VAEp|[g (8bito)
+*/
+static int outPrn8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
+	 case 0x0240: /* VAEp|[g Xe[^X */
+	 	/* 1 0 0 0 DTR RTS INIT STB */
+	 	/*printf("COM/PRN %s %s %s %s %s %s %s %s\n",
+	 	x & 0x80 ? "1": "0",
+	 	x & 0x40 ? "1": "0",
+	 	x & 0x20 ? "1": "0",
+	 	x & 0x10 ? "1": "0",
+	 	x & 0x08 ? "DTR": "-",
+	 	x & 0x04 ? "RTS": "-",
+	 	x & 0x02 ? "INIT": "-",
+	 	x & 0x01 ? "STB": "-");*/
+	 	return FALSE;
+	 case 0x0241:
+	 	/*printf("COM/PRN %02x\n", x);*/
+	 	return FALSE;
+
+	case 0x0280: /* p|[g o */
+		/*printf("PRN SEND %c(%02x)\n", x, x);*/
+		if(x != 0xff)
+			sendIOData(&z1->printer, x);
+		return FALSE;
+
+	default:
+		return FALSE;
+	}
+}
+
+/*
+	VXe (8bit)
+*/
+static uint8 inSys8(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
+	case 0x005a: /* obe[e */
+		return 0x04 | z1->setting.machine;
+	case 0x005b:
+		return 0x00;
+
+	case 0x0082: /* RAMe */
+		return *LOW(z1->setting.iram_size);
+	case 0x0083:
+		return *HIGH(z1->setting.iram_size);
+
+	case 0x0086: /* gRAMe */
+		return *LOW(z1->setting.oram_size);
+	case 0x0087:
+		return *HIGH(z1->setting.oram_size);
+
+	case 0x00a2: /* ??? */
+		return 0x0a;
+	case 0x00a3:
+		return 0x80;
+
+	case 0x00a6: /* ??? */
+		return 0xce;
+	case 0x00a7:
+		return 0xff;
+
+	case 0x00b8: /* dRg[ */
+		return *LOW(z1->power);
+	case 0x00b9:
+		return *HIGH(z1->power);
+
+	case 0x0274: /* ??? */
+		return 0x76;
+	case 0x0275:
+		return 0x75;
+
+	default:
+		return 0x00;
+	}
+}
+
+/*
+	VXe (8bito)
+*/
+static int outSys8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
+	case 0x00b8: /* dRg[ */
+		*LOW(z1->power) = x & 0x03;
+		return x & 0x01;
+	case 0x00b9:
+		*HIGH(z1->power) = 0;
+		return FALSE;
+
+	default:
+		return FALSE;
+	}
+}
+
+/*
+	L[Ԃ̃|[g̒lXV
+*/
+void updateKeyMatrix(Z1stat *z1)
+{
+	uint16 v, rows;
+	int i;
+
+	if(z1->key.rows == 0) { /* ǂ̃L[ĂȂ */
+		z1->key.value = 0x8000;
+		return;
+	}
+
+	v = z1->key.matrix[11];
+	for(i = 0, rows = z1->key.strobe & z1->key.rows & 0x07ff; rows != 0; i++, rows >>= 1)
+		if(rows & 1)
+			v |= z1->key.matrix[i];
+	z1->key.value = (v ? v: 0x8000);
+}
+
+/*
+	L[ (8bit)
+*/
+static uint8 inKey8(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
+	case 0x0202: /* L[ */
+		return *LOW(z1->key.value);
+	case 0x0203:
+		return *HIGH(z1->key.value);
+
+	case 0x0204: /* L[Rg[ */
+		return 0x04;
+	case 0x0205:
+		return 0x00;
+
+	default:
+		return 0x00;
+	}
+}
+
+/*
+	L[ (16bit)
+*/
+static uint16 inKey16(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
+	case 0x0202: /* L[ */
+		return z1->key.value;
+	default:
+		return ((uint16 )inKey8(i86, port + 1) << 8) | inKey8(i86, port);
+	}
+}
 
-	case 0x00b8: /* dRg[ */
-		*LOW(z1->power) = x & 0x03;
-		return x & 0x01;
-	case 0x00b9:
-		*HIGH(z1->power) = 0;
-		return FALSE;
+/*
+	L[ (8bito)
+*/
+static int outKey8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
 
+	switch(port) {
 	case 0x0200: /* L[Xg[u */
-		/*i86->i.op_states += 12;*/
 		*LOW(z1->key.strobe) = x;
+		updateKeyMatrix(z1);
 		return FALSE;
 	case 0x0201:
-		/*i86->i.op_states += 12;*/
 		*HIGH(z1->key.strobe) = x;
+		updateKeyMatrix(z1);
 		return FALSE;
 
 	case 0x0204: /* L[Rg[ */
@@ -591,19 +679,83 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 		*HIGH(z1->key.key_control) = 0;
 		return FALSE;
 
+	default:
+		return FALSE;
+	}
+}
+
+/*
+	L[ (16bito)
+*/
+static int outKey16(I86stat *i86, uint16 port, uint16 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+	int result;
+
+	switch(port) {
+	case 0x0200: /* L[Xg[u */
+		z1->key.strobe = x;
+		updateKeyMatrix(z1);
+		return FALSE;
+	default:
+		result = outKey8(i86, port, x & 0xff);
+		result |= outKey8(i86, port + 1, x >> 8);
+		return result;
+	}
+}
+
+/*
+	uU[ (8bito)
+*/
+static int outBuzzer8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+
+	switch(port) {
 	case 0x0206: /* uU[ */
 		/*printf("BUZZER=%02x\n", x);*/
 		z1->buzzer = x;
 		writeSound(z1, z1->buzzer);
 		return FALSE;
-	case 0x0207:
+
+	default:
 		return FALSE;
+	}
+}
+
+/*
+	Z (8bit)
+*/
+static uint8 inCal8(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+	uint8 f;
+
+	switch(port) {
+	case 0x0220: /* Z */
+		getCalResult(z1, &f);
+		return f;
+
+	default:
+		return 0x00;
+	}
+}
 
+/*
+	Z (8bito)
+*/
+static int outCal8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
+	uint8 f, a[16];
+
+	switch(port) {
 	case 0x0220: /* Z */
 		/*z1->cpu.i.op_states += z1->setting.cpu_clock / 20340;*/ /* ??? */
 
 		z1->cal.op = x;
-		opXY(z1->cal.op, &i86->m[0x400], &i86->m[0x410], a, &f);
+		z1->cal.valid = FALSE;
+		memcpy(a, getCalResult(z1, &f), sizeof(a));
 
 		/*
 		printf("OP=%02x\n", z1->cal.op);
@@ -642,10 +794,10 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 
 			switch(z1->cal.op & 0x04) {
 			case 0x00: /* Vtg(10{) */
-				encodeMan(z1->cal.reg, decodeMan(z1->cal.reg) * 10LL);
+				shiftMan(z1->cal.reg, TRUE);
 				break;
 			case 0x04: /* EVtg(101) */
-				encodeMan(z1->cal.reg, decodeMan(z1->cal.reg) / 10LL);
+				shiftMan(z1->cal.reg, FALSE);
 				break;
 			}
 		} else if(z1->cal.op & 0x80) /* ZʂWX^ɑ */
@@ -656,6 +808,8 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 		}
 		return FALSE;
 	case 0x0221:
+		z1->cal.valid = FALSE;
+
 		switch(x & 0x80) {
 		case 0x80: /* XY */
 			memcpy(a, &i86->m[0x0400], 9);
@@ -689,30 +843,115 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 		}
 		return FALSE;
 
-	 case 0x0240: /* VAEp|[g Xe[^X */
-	 	/* 1 0 0 0 DTR RTS INIT STB */
-	 	/*printf("COM/PRN %s %s %s %s %s %s %s %s\n",
-	 	x & 0x80 ? "1": "0",
-	 	x & 0x40 ? "1": "0",
-	 	x & 0x20 ? "1": "0",
-	 	x & 0x10 ? "1": "0",
-	 	x & 0x08 ? "DTR": "-",
-	 	x & 0x04 ? "RTS": "-",
-	 	x & 0x02 ? "INIT": "-",
-	 	x & 0x01 ? "STB": "-");*/
-	 	return FALSE;
-	 case 0x0241:
-	 	/*printf("COM/PRN %02x\n", x);*/
-	 	return FALSE;
 
-	case 0x0280: /* p|[g o */
-		/*printf("PRN SEND %c(%02x)\n", x, x);*/
-		if(x != 0xff)
-			sendIOData(&z1->printer, x);
-		return FALSE;
-	case 0x0281:
+	default:
 		return FALSE;
+	}
+}
+
+/*
+	FDD (8bit)
+*/
+static uint8 inFdd8(I86stat *i86, uint16 port)
+{
+	Z1stat *z1 = i86->i.user_data;
+	uint32 size;
+
+	switch(port) {
+	case 0x02a6: /* FDD */
+		/*  */
+		/*printf("FDD DATA? CMD=%02x, COUNT=%d, DATA=%02x, ERR=%02x\n", z1->fdd.cmd, z1->disk.result_count, z1->disk.data, z1->fdd.err);*/
+		switch(z1->fdd.cmd) {
+		case 0x03: /* t@C */
+			z1->fdd.err = getFoundFdFile(&z1->disk, &z1->disk.data);
+			return z1->disk.data;
+		default:
+			return z1->disk.data;
+		}
+	case 0x02a7:
+		/* s 01:G[, 02:R}h, 04:R}hJn, 08:R}h튮, 10:foCX */
+		if(z1->disk.result_count < 0)
+			return 0x1e;
+		/*printf("FDD STAT? CMD=%02x, PARAM=%s, LEN=%d, COUNT=%d, ERR=%02x\n", z1->fdd.cmd, z1->fdd.param, (int )(z1->fdd.param_p - z1->fdd.param), z1->disk.result_count, z1->fdd.err);*/
+
+		switch(z1->fdd.cmd) {
+		case 0x10: /* fBXN󂫗e */
+			z1->fdd.err = getFdFreeSize(&z1->disk, &size);
+
+			if(z1->disk.result_count == 0)
+				z1->disk.data = z1->fdd.err;
+			else if(z1->disk.result_count == 1)
+				z1->disk.data = size & 0xff;
+			else if(z1->disk.result_count == 2)
+				z1->disk.data = (size >> 8) & 0xff;
+			else if(z1->disk.result_count == 3)
+				z1->disk.data = (size >> 16) & 0xff;
+			else if(z1->disk.result_count == 4)
+				z1->disk.data = (size >> 24) & 0xff;
+			else
+				z1->disk.data = 0x00;
+			break;
+		case 0x12: /* t@C */
+			if(z1->disk.result_count == 0)
+				z1->disk.data = z1->fdd.err = 0x00;
+			else if(z1->disk.result_count == 1)
+				z1->fdd.err = findFdFile(&z1->disk, &z1->fdd.param[0], &z1->disk.data);
+			else if(z1->disk.result_count == 2)
+				z1->disk.data = 0x00;
+			else if(z1->disk.result_count == 3)
+				z1->disk.data = 0x00;
+			break;
+		case 0x13: /* t@CꊇǍI[v */
+			if(z1->disk.result_count == 0)
+				z1->disk.data = z1->fdd.err;
+			else if(z1->disk.result_count == 1)
+				z1->disk.data = z1->disk.size & 0xff;
+			else if(z1->disk.result_count == 2)
+				z1->disk.data = (z1->disk.size >> 8) & 0xff;
+			else if(z1->disk.result_count == 3)
+				z1->disk.data = (z1->disk.size >> 16) & 0xff;
+			else if(z1->disk.result_count == 4)
+				z1->disk.data = (z1->disk.size >> 24) & 0xff;
+			else if(z1->disk.result_count < 4 + z1->disk.size)
+				z1->fdd.err = readFdFile(&z1->disk, &z1->disk.data);
+			else
+				z1->disk.data = 0x00;
+			break;
+		case 0x1b: /* t@CǍ/ */
+			if(z1->disk.result_count == 0)
+				z1->disk.data = z1->fdd.err;
+			else if(z1->disk.result_count == 1)
+				*LOW(z1->disk.len) = z1->disk.data = z1->disk.size - z1->disk.pos >= 0x100 ? 0x00: z1->disk.size - z1->disk.pos;
+			else if(z1->disk.result_count == 2)
+				*HIGH(z1->disk.len) = z1->disk.data = z1->disk.size - z1->disk.pos >= 0x100 ? 0x01: 0x00;
+			else if(z1->disk.result_count < 3 + MIN(z1->disk.len, 256))
+				z1->fdd.err = readFdFile(&z1->disk, &z1->disk.data);
+			else
+				z1->disk.data = 0x00;
+			break;
+		default:
+			if(z1->disk.result_count == 0)
+				z1->disk.data = z1->fdd.err;
+			else
+				z1->disk.data = 0x00;
+			break;
+		}
+		z1->disk.result_count++;
+		return (z1->fdd.err ? 0x01: 0x1e);
+
+	default:
+		return 0x00;
+	}
+}
+
+/*
+	FDD (8bito)
+*/
+static int outFdd8(I86stat *i86, uint16 port, uint8 x)
+{
+	Z1stat *z1 = i86->i.user_data;
 
+	switch(port) {
 	case 0x02a6: /* FDD */
 		/* p[^ */
 		if(z1->fdd.param_p == NULL)
@@ -808,12 +1047,82 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 		}
 		return FALSE;
 
- 	default:
- 		/*
+	default:
+		return FALSE;
+	}
+}
+
+static const struct IOHandler intrHandler = { inIntr8, outIntr8, inIntr16, outIntr16 }; /* Rg[ */
+static const struct IOHandler timerHandler = { inTimer8, outTimer8, inTimer16, outTimer16 }; /* ^C} */
+static const struct IOHandler sioHandler = { inSio8, outSio8, NULL, NULL }; /* VA|[g */
+static const struct IOHandler prnHandler = { inPrn8, outPrn8, NULL, NULL }; /* VAEp|[g */
+static const struct IOHandler sysHandler = { inSys8, outSys8, NULL, NULL }; /* VXe */
+static const struct IOHandler keyHandler = { inKey8, outKey8, inKey16, outKey16 }; /* L[ */
+static const struct IOHandler buzzerHandler = { NULL, outBuzzer8, NULL, NULL }; /* uU[ */
+static const struct IOHandler calHandler = { inCal8, outCal8, NULL, NULL }; /* Z */
+static const struct IOHandler fddHandler = { inFdd8, outFdd8, NULL, NULL }; /* FDD */
+
+/*
+	|[g̃nh𓾂
+*/
+static inline const struct IOHandler *getIOHandler(const Z1stat *z1, uint16 port)
+{
+	const struct IOHandler **page = z1->io[port >> 8];
+
+	return (page != NULL ? page[port & 0xff]: NULL);
+}
+
+/*
+	InportG~[g (8bit)
+*/
+uint8 i86inp8(I86stat *i86, uint16 port)
+{
+	const struct IOHandler *h = getIOHandler(i86->i.user_data, port);
+
+	/*
+	printf("IO IN %04x\n", port);
+	*/
+	i86->i.op_states += 12;
+
+	if(h == NULL || h->in8 == NULL) {
+		/*printf("IO IN %04x\n", port);*/
+		return 0;
+	}
+	return h->in8(i86, port);
+}
+
+/*
+	InportG~[g (16bit)
+*/
+uint16 i86inp16(I86stat *i86, uint16 port)
+{
+	const struct IOHandler *h = getIOHandler(i86->i.user_data, port);
+
+	if(h != NULL && h->in16 != NULL && !(port & 1)) {
+		i86->i.op_states += 24;
+		return h->in16(i86, port);
+	}
+	return ((uint16 )i86inp8(i86, port + 1) << 8) | i86inp8(i86, port);
+}
+
+/*
+	OutportG~[g (8bit)
+*/
+int i86out8(I86stat *i86, uint16 port, uint8 x)
+{
+	const struct IOHandler *h = getIOHandler(i86->i.user_data, port);
+
+	/*printf("OUT8  %04x,%02x\n", port, x);*/
+
+	i86->i.op_states += 12;
+
+	if(h == NULL || h->out8 == NULL) {
+		/*
 		printf("IO OUT %04x,%02x\n", port, x);
 		*/
 		return FALSE;
 	}
+	return h->out8(i86, port, x);
 }
 
 /*
@@ -821,15 +1130,67 @@ int i86out8(I86stat *i86, uint16 port, uint8 x)
 */
 int i86out16(I86stat *i86, uint16 port, uint16 x)
 {
+	const struct IOHandler *h = getIOHandler(i86->i.user_data, port);
 	int result;
 
 	/*printf("OUT16 %04x,%04x\n", port, x);*/
 
+	if(h != NULL && h->out16 != NULL && !(port & 1)) {
+		i86->i.op_states += 24;
+		return h->out16(i86, port, x);
+	}
 	result = i86out8(i86, port, x & 0xff);
 	result |= i86out8(i86, port + 1, x >> 8);
 	return result;
 }
 
+/*
+	|[gɃnho^
+	(16bit̃nh͋̃|[g2oCg𓯂nhɓo^Ƃg)
+*/
+int registerIOPort(Z1stat *z1, uint16 first, uint16 last, const struct IOHandler *h)
+{
+	int port;
+
+	for(port = first; port <= last; port++) {
+		if(z1->io[port >> 8] == NULL && (z1->io[port >> 8] = calloc(0x100, sizeof(*z1->io[0]))) == NULL)
+			return FALSE;
+		z1->io[port >> 8][port & 0xff] = h;
+	}
+	return TRUE;
+}
+
+/*
+	I/O|[go^
+*/
+int initIO(Z1stat *z1)
+{
+	updateKeyMatrix(z1);
+
+	return
+	registerIOPort(z1, 0x0002, 0x0003, &intrHandler) &&
+	registerIOPort(z1, 0x0008, 0x0009, &intrHandler) &&
+	registerIOPort(z1, 0x000c, 0x000d, &intrHandler) &&
+	registerIOPort(z1, 0x0012, 0x001f, &intrHandler) &&
+	registerIOPort(z1, 0x0030, 0x0043, &timerHandler) &&
+	registerIOPort(z1, 0x0046, 0x0047, &timerHandler) &&
+	registerIOPort(z1, 0x005a, 0x005b, &sysHandler) &&
+	registerIOPort(z1, 0x0060, 0x0061, &sioHandler) &&
+	registerIOPort(z1, 0x0064, 0x006b, &sioHandler) &&
+	registerIOPort(z1, 0x0082, 0x0083, &sysHandler) &&
+	registerIOPort(z1, 0x0086, 0x0087, &sysHandler) &&
+	registerIOPort(z1, 0x00a2, 0x00a3, &sysHandler) &&
+	registerIOPort(z1, 0x00a6, 0x00a7, &sysHandler) &&
+	registerIOPort(z1, 0x00b8, 0x00b9, &sysHandler) &&
+	registerIOPort(z1, 0x0200, 0x0205, &keyHandler) &&
+	registerIOPort(z1, 0x0206, 0x0207, &buzzerHandler) &&
+	registerIOPort(z1, 0x0220, 0x0221, &calHandler) &&
+	registerIOPort(z1, 0x0240, 0x0241, &prnHandler) &&
+	registerIOPort(z1, 0x0274, 0x0275, &sysHandler) &&
+	registerIOPort(z1, 0x0280, 0x0281, &prnHandler) &&
+	registerIOPort(z1, 0x02a6, 0x02a7, &fddHandler);
+}
+
 /*
 	Copyright 2009~2019 maruhiro
 	All rights reserved. 
@@ -0,0 +1,327 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	tgGh (libz1core g)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "depend.h"
+
+/* }V (Iɔj) */
+static Z1stat *machine = NULL;
+
+/*
+	16i̕𐔒lɕϊ
+*/
+static int atoix(const char *buf)
+{
+	int result;
+
+	sscanf(buf, "%x", &result);
+	return result;
+}
+
+/*
+	I/O|[g̏Ԃ^Cgɕ\ (Ԋu)
+*/
+static void showIOPort(Z1stat *z1)
+{
+	static int count = 0;
+	struct IOPort *ports[] = { &z1->rs_send, &z1->printer, &z1->rs_receive }, *s;
+	char buf[PATH_MAX + 32];
+	int i;
+
+	if(++count < z1->setting.refresh_rate / 4)
+		return;
+	count = 0;
+
+	for(i = 0; i < sizeof(ports) / sizeof(ports[0]); i++) {
+		s = ports[i];
+		if(MAX(s->pos, 0) == s->shown_pos)
+			continue;
+		s->shown_pos = MAX(s->pos, 0);
+
+		sprintf(buf, "%s %dbytes", s->path, s->shown_pos);
+		setTitle(buf);
+		break;
+	}
+}
+
+/*
+	TEh̎肱ڂ\
+*/
+static void showSound(Z1stat *z1)
+{
+	struct Sound *sound = &z1->sound;
+	unsigned int underrun, overrun;
+	char buf[64];
+
+	if(sound->len == 0)
+		return;
+
+	underrun = atomic_load_explicit(&sound->underrun, memory_order_relaxed);
+	overrun = atomic_load_explicit(&sound->overrun, memory_order_relaxed);
+	if(underrun == sound->shown_underrun && overrun == sound->shown_overrun)
+		return;
+	sound->shown_underrun = underrun;
+	sound->shown_overrun = overrun;
+
+	/* ^[{͖炳Ȃ̂ŕ\Ȃ */
+	if(z1->turbo.on)
+		return;
+
+	sprintf(buf, "sound underrun %u, overrun %usamples", underrun, overrun);
+	setTitle(buf);
+}
+
+/*
+	LCDXV
+*/
+static void updateLCD(Z1stat *z1)
+{
+	/* `XbhΔC */
+	if(z1->setting.render_thread) {
+		postLCD(z1);
+		return;
+	}
+
+	fadeLCD(&z1->lcd, z1->vram.vram, z1->vram.status, getLCDFade(z1));
+	updateWindow(z1);
+}
+
+/*
+	1҂, sXe[g̕␳𓾂
+*/
+static int waitFrame(Z1stat *z1)
+{
+	struct Sound *sound = &z1->sound;
+	int frame = z1->setting.cpu_clock / z1->setting.refresh_rate, fill, adjust;
+	int64 limit, now;
+
+	/* oȂƂ̓^C}ő҂ */
+	if(z1->setting.pacing != PACING_AUDIO || sound->len == 0) {
+		delay(z1->setting.refresh_rate);
+		return 0;
+	}
+
+	/* Oobt@̎cʂڕW܂Ō̂҂ (Đ~܂ĂƂ̓^C}ő҂) */
+	limit = getClock() + (int64 )AUDIO_WAIT_FRAMES * 1000000000 / z1->setting.refresh_rate;
+	while((fill = getSoundFill(sound)) > sound->target) {
+		if((now = getClock()) >= limit) {
+			delay(z1->setting.refresh_rate);
+			return 0;
+		}
+		sleepMs((int )MIN(MAX((fill - sound->target) * 1000 / AUDIO_RATE, 1), (limit - now) / 1000000 + 1));
+	}
+
+	/* ڕWɑȂs */
+	adjust = (int )((int64 )(sound->target - fill) * z1->setting.cpu_clock / AUDIO_RATE);
+	return MIN(adjust, frame / 2);
+}
+
+/*
+	sx\
+*/
+static void showSpeed(Z1stat *z1)
+{
+	struct Speed *speed = &z1->speed;
+	int64 now = getClock();
+
+	if(speed->start_clock == 0) {
+		speed->start_clock = now;
+		speed->start_states = z1->elapsed_states;
+		return;
+	}
+
+	/* 1bƂɎ@ɑ΂銄߂ */
+	if(now - speed->start_clock < 1000000000)
+		return;
+	setSpeed((int )((double )(z1->elapsed_states - speed->start_states) * 1e11 / ((double )z1->setting.cpu_clock * (now - speed->start_clock)) + 0.5));
+	speed->start_clock = now;
+	speed->start_states = z1->elapsed_states;
+}
+
+/*
+	^[{؂ւ
+*/
+void setTurbo(Z1stat *z1, int on)
+{
+	z1->turbo.on = on;
+	z1->turbo.start_ticks = z1->turbo.shown_ticks = getTicks();
+	z1->turbo.start_states = z1->elapsed_states;
+	setTitle(on ? "turbo": "");
+}
+
+/*
+	^[{̑xɗ}
+*/
+static void waitTurbo(Z1stat *z1)
+{
+	struct Turbo *turbo = &z1->turbo;
+	uint32 elapsed, expected;
+
+	if(z1->setting.turbo_limit == 0)
+		return;
+
+	/* ̑xŎsƂɂ鎞(~b) */
+	expected = (uint32 )((z1->elapsed_states - turbo->start_states) * 1000 / ((uint64 )z1->setting.cpu_clock * z1->setting.turbo_limit));
+	elapsed = getTicks() - turbo->start_ticks;
+	if(expected > elapsed)
+		sleepMs(expected - elapsed);
+	else if(elapsed - expected > 100) {
+		/* 傫xꂽƂ͎߂Ɋ߂ */
+		turbo->start_ticks += elapsed - expected;
+	}
+}
+
+/*
+	^[{ŉʂƃL[̍XVȂ?
+*/
+static int isTurboSkip(Z1stat *z1)
+{
+	uint32 now;
+
+	if(!z1->turbo.on)
+		return FALSE;
+
+	now = getTicks();
+	if(now - z1->turbo.shown_ticks < 1000 / TURBO_REFRESH)
+		return TRUE;
+	z1->turbo.shown_ticks = now;
+	return FALSE;
+}
+
+/*
+	}Vj (I)
+*/
+static void destroyMachine(void)
+{
+	destroyZ1(machine);
+	machine = NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	Z1stat *z1;
+	int64 states = 0;
+	uint64 top;
+	int i;
+
+#if SDL_MAJOR_VERSION == 1
+#ifdef _WIN32
+	argv = argvToUTF8(argc, argv);
+#endif
+#endif
+
+	/* G~[^ */
+	if((machine = z1 = createZ1("z1f9config", argc, argv)) == NULL)
+		return 1;
+	atexit(destroyMachine);
+
+	/* ˑ */
+	if(!initDepend(z1, argc, argv))
+		return 1;
+
+	/* RAMǂݍ */
+	loadZ1RAM(z1, z1->setting.path_ram);
+
+	for(i = 1; i < argc; i++)
+		if(*argv[i] != '-') {
+			if(!loadZ1Program(z1, argv[i], -1)) {
+				showError("CANNOT OPEN FILE. (%s)\n", argv[i]);
+				return 1;
+			}
+			for(i = i + 1; i < argc; i++)
+				if(*argv[i] != '-')
+					z1->run.start = atoix(argv[i]);
+		}
+
+	/* ROMǂݍ (Ȃ΋[ROMŃvOs) */
+	if(strcmp(z1->setting.path_rom, "") == 0) {
+		if(z1->run.start < 0) {
+			showError("NO ROM IMAGE.\n");
+			return 1;
+		}
+		loadZ1ROM(z1, NULL);
+	} else if(!loadZ1ROM(z1, z1->setting.path_rom)) {
+		showError("CANNOT OPEN ROM IMAGE FILE. (%s)\n", z1->setting.path_rom);
+		if(z1->run.start < 0)
+			return 1;
+		loadZ1ROM(z1, NULL);
+	}
+
+	/* Zbg */
+	resetZ1(z1);
+
+	if(z1->turbo.on)
+		setTurbo(z1, TRUE);
+
+	for(;;) {
+		/* 1҂ */
+		do {
+			states += z1->setting.cpu_clock / z1->setting.refresh_rate;
+			if(z1->turbo.on)
+				waitTurbo(z1);
+			else if(!isAutoKey(z1))
+				states += waitFrame(z1);
+		} while(states < 0);
+
+		/* s */
+		top = getZ1States(z1);
+		if(runZ1(z1, states, Z1_EVENT_NONE) == Z1_EVENT_POWEROFF)
+			break;
+		states -= (int64 )(getZ1States(z1) - top);
+
+		/* ^[{͈̊ԊułXVȂ */
+		if(isTurboSkip(z1))
+			continue;
+
+		/* ʂXV */
+		updateLCD(z1);
+
+		/* L[XV */
+		startKeyIntr(z1, updateKey(z1));
+
+		/* o͂oCg\ */
+		showIOPort(z1);
+
+		/* TEh̎肱ڂ\ */
+		showSound(z1);
+
+		/* sx\ */
+		showSpeed(z1);
+	}
+
+	/* RAM̓eۑ */
+	if(strcmp(z1->setting.path_ram, "") != 0)
+		saveZ1RAM(z1, z1->setting.path_ram);
+	return 0;
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
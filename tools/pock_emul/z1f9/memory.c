@@ -192,12 +192,9 @@ uint8 i86read8(I86stat *cpu, uint16 seg, uint16 off)
 		else if(p >= 0x0400) {
 			Z1stat *z1 = cpu->i.user_data;
 
-			if(z1->cal.map) { /* Z */
-				uint8 a[16], f;
-
-				opXY(z1->cal.op, &cpu->m[0x0400], &cpu->m[0x0410], a, &f);
-				return a[p - 0x0400];
-			} else /* X */
+			if(z1->cal.map) /* Z */
+				return getCalResult(z1, NULL)[p - 0x0400];
+			else /* X */
 				return cpu->m[p];
 		} else /* RAM */
 			return cpu->m[p];
@@ -218,9 +215,11 @@ void i86write8(I86stat *cpu, uint16 seg, uint16 off, uint8 v)
 {
 	int p = (((int )seg << 4) + off) & 0xfffff;
 
-	if(p < 0x40000) /* RAM */
+	if(p < 0x40000) { /* RAM */
 		cpu->m[p] = v;
-	else if(p < 0xa0000) /* ROM܂̓Ȃ */
+		if(p >= 0x0400 && p < 0x0419) /* X, Y */
+			((Z1stat *)cpu->i.user_data)->cal.valid = FALSE;
+	} else if(p < 0xa0000) /* ROM܂̓Ȃ */
 		return;
 	else if(p < 0xb0000) /* VRAM */
 		writeVram(cpu, p, v);
@@ -0,0 +1,211 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	uU[̘^
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include "z1.h"
+
+#ifndef O_BINARY
+#	define O_BINARY	0
+#endif
+
+/* obt@̑傫 (2ׂ̂, 24b) */
+#define RECORD_SIZE	0x100000
+
+/* 1ɏރTv */
+#define RECORD_BLOCK	0x10000
+
+/* wb_XVԊu(Tv) */
+#define RECORD_UPDATE	(AUDIO_RATE * 10)
+
+/* ^̏ */
+struct Record {
+	uint8 *buffer; /* ҂̃Tv */
+	unsigned int read, write; /* ǏoʒuEʒu */
+	int quit; /* I邩? */
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	pthread_t thread;
+
+	int fd; /* o̓t@C */
+	int written; /* 񂾃Tv */
+	int dropped; /* Ԃɍ킸̂ĂTv */
+};
+
+/*
+	Tvt@Cɏ (recordLoop̉)
+*/
+static void writeSamples(struct Record *rec, unsigned int r, int len)
+{
+	int n;
+
+	while(len > 0) {
+		n = MIN(len, RECORD_SIZE - (int )(r & (RECORD_SIZE - 1)));
+		if(write(rec->fd, rec->buffer + (r & (RECORD_SIZE - 1)), n) != n)
+			return;
+		r += n;
+		len -= n;
+
+		/* rŎ~܂Ăǂ߂悤ɂƂǂwb_XV */
+		if(rec->written / RECORD_UPDATE != (rec->written + n) / RECORD_UPDATE)
+			writeWaveHeader(rec->fd, rec->written + n);
+		rec->written += n;
+	}
+}
+
+/*
+	Xbh
+*/
+static void *recordLoop(void *arg)
+{
+	struct Record *rec = arg;
+	unsigned int r;
+	int len;
+
+	pthread_mutex_lock(&rec->mutex);
+	for(;;) {
+		while(rec->write - rec->read < RECORD_BLOCK && !rec->quit)
+			pthread_cond_wait(&rec->cond, &rec->mutex);
+		if(rec->write == rec->read)
+			break;
+
+		/* ̓bNO */
+		r = rec->read;
+		len = MIN(rec->write - rec->read, RECORD_BLOCK);
+		pthread_mutex_unlock(&rec->mutex);
+		writeSamples(rec, r, len);
+		pthread_mutex_lock(&rec->mutex);
+		rec->read = r + len;
+	}
+	pthread_mutex_unlock(&rec->mutex);
+	return NULL;
+}
+
+/*
+	Tv^
+*/
+void recordSound(Z1stat *z1, const int8 *sample, int len)
+{
+	struct Record *rec = z1->record;
+	unsigned int w;
+	int i;
+
+	if(rec == NULL)
+		return;
+
+	/* obt@tȂΎ̂Ă */
+	pthread_mutex_lock(&rec->mutex);
+	if(len > RECORD_SIZE - (int )(rec->write - rec->read)) {
+		rec->dropped += len - (RECORD_SIZE - (rec->write - rec->read));
+		len = RECORD_SIZE - (rec->write - rec->read);
+	}
+	pthread_mutex_unlock(&rec->mutex);
+
+	/* Xbh͓ǏoʒuOGȂ̂ŃbNɏ */
+	w = rec->write;
+	for(i = 0; i < len; i++)
+		rec->buffer[(w + i) & (RECORD_SIZE - 1)] = (uint8 )(sample[i] + 0x80);
+
+	pthread_mutex_lock(&rec->mutex);
+	rec->write = w + len;
+	if(rec->write - rec->read >= RECORD_BLOCK)
+		pthread_cond_signal(&rec->cond);
+	pthread_mutex_unlock(&rec->mutex);
+}
+
+/*
+	^I
+*/
+void stopRecord(Z1stat *z1)
+{
+	struct Record *rec = z1->record;
+
+	if(rec == NULL)
+		return;
+
+	pthread_mutex_lock(&rec->mutex);
+	rec->quit = TRUE;
+	pthread_cond_signal(&rec->cond);
+	pthread_mutex_unlock(&rec->mutex);
+	pthread_join(rec->thread, NULL);
+
+	writeWaveHeader(rec->fd, rec->written);
+	close(rec->fd);
+	if(rec->dropped > 0)
+		fprintf(stderr, "record: %d samples dropped.\n", rec->dropped);
+	pthread_mutex_destroy(&rec->mutex);
+	pthread_cond_destroy(&rec->cond);
+	free(rec->buffer);
+	free(rec);
+	z1->record = NULL;
+}
+
+/*
+	^
+*/
+int initRecord(Z1stat *z1)
+{
+	struct Record *rec;
+
+	if(strcmp(z1->setting.path_wave, "") == 0)
+		return TRUE;
+
+	if((rec = calloc(1, sizeof(*rec))) == NULL)
+		return FALSE;
+	if((rec->buffer = malloc(RECORD_SIZE)) == NULL) {
+		free(rec);
+		return FALSE;
+	}
+	if((rec->fd = open(z1->setting.path_wave, O_CREAT | O_TRUNC | O_WRONLY | O_BINARY, 0664)) < 0) {
+		fprintf(stderr, "CANNOT OPEN WAVE FILE. (%s)\n", z1->setting.path_wave);
+		free(rec->buffer);
+		free(rec);
+		return FALSE;
+	}
+	writeWaveHeader(rec->fd, 0);
+
+	pthread_mutex_init(&rec->mutex, NULL);
+	pthread_cond_init(&rec->cond, NULL);
+	if(pthread_create(&rec->thread, NULL, recordLoop, rec) != 0) {
+		fprintf(stderr, "pthread_create fail.\n");
+		close(rec->fd);
+		free(rec->buffer);
+		free(rec);
+		return FALSE;
+	}
+	z1->record = rec;
+	return TRUE;
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
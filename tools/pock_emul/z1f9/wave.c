@@ -174,14 +174,11 @@ fail:;
 }
 
 /*
-	WAVE`ŏ
+	WAVEt@C̃wb_ (t@Cʒu͖Ɉڂ)
 */
-int writeWave(const char *path, unsigned char *data, int data_size)
+int writeWaveHeader(int fd, int data_size)
 {
-	int fd;
-
-	if((fd = open(path, O_CREAT | O_TRUNC | O_WRONLY | O_BINARY, 0664)) < 0)
-		return -1;
+	lseek(fd, 0, SEEK_SET);
 
 	/* RIFFwb_ */
 	write(fd, "RIFF", 4);
@@ -203,6 +200,21 @@ int writeWave(const char *path, unsigned char *data, int data_size)
 	/* data`N */
 	write(fd, "data", 4);
 	write4(fd, data_size);
+
+	return lseek(fd, 0, SEEK_END);
+}
+
+/*
+	WAVE`ŏ
+*/
+int writeWave(const char *path, unsigned char *data, int data_size)
+{
+	int fd;
+
+	if((fd = open(path, O_CREAT | O_TRUNC | O_WRONLY | O_BINARY, 0664)) < 0)
+		return -1;
+
+	writeWaveHeader(fd, data_size);
 	if(data != NULL)
 		write(fd, data, data_size);
 
@@ -2,11 +2,20 @@
 	CASIO Z-1/FX-890P emulator
 */
 
+/* posix_openptg(glibc) */
+#define _GNU_SOURCE
+
 #ifdef _WIN32
 #include <windows.h>
+#include <io.h>
 #else
 #include <unistd.h>
 #include <dirent.h>
+#include <poll.h>
+#include <termios.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 #include <sys/statvfs.h>
 #endif
 #include <stdio.h>
@@ -18,13 +27,13 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
-#define DEF_GLOBAL
+#include <time.h>
+#include <pthread.h>
 #include "z1.h"
-#include "pseudorom.h"
 
 #ifdef _WIN32
-/* t@Cpꎞobt@ (win32p) */
-static wchar_t _wbuffer1[PATH_MAX], _wbuffer2[PATH_MAX];
+/* t@Cpꎞobt@ (win32p, Xbh) */
+static __thread wchar_t _wbuffer1[PATH_MAX], _wbuffer2[PATH_MAX];
 
 /*
 	UTF-8wchar_tɕϊ() (win32p)
@@ -63,115 +72,7 @@ static wchar_t *utf8ToWchar(wchar_t *utf16, const char *utf8)
 void i86trace(I86stat *i86)
 {
 	char buf[256];
-	log("%s%dclocks\n\n", i86regs(buf, i86), i86->i.total_states - i86->i.states);
-}
-
-int atoix(const char *buf)
-{
-	int result;
-
-	sscanf(buf, "%x", &result);
-	return result;
-}
-
-/*
-	eLXgt@CꂽoCit@Cǂݍ
-*/
-static size_t readTextBin(const char *path, size_t buf_size, uint8 *buf)
-{
-	FILE *fp;
-	int i, x;
-	uint8 *p = buf;
-	char tmp[256];
-
-	if((fp = fopen(path, "r")) == NULL)
-		return 0;
-
-	while(!feof(fp) && p < buf + buf_size) {
-		fgets(tmp, sizeof(tmp), fp);
-		for(i = 0; i < strlen(tmp); i += 2)
-			if(isalnum(tmp[i])) {
-				sscanf(&tmp[i], "%02x", &x);
-				*p++ = (uint8 )x;
-			} else
-				break;
-	}
-
-	fclose(fp);
-	return (size_t )(p - buf);
-}
-
-/*
-	oCit@Cǂݍ
-*/
-static size_t readBin(const char *path, size_t buf_size, void *buf)
-{
-	FILE *fp;
-	size_t size;
-
-	if((fp = fopen(path, "rb")) < 0)
-		return 0;
-	size = fread(buf, 1, buf_size, fp);
-	fclose(fp);
-	return size;
-}
-
-/*
-	ROMC[Wǂݍ
-*/
-static size_t readROM(const char *path, uint8 *p)
-{
-	if(readTextBin(path, 0x20000, p) == 0x20000)
-		return TRUE;
-	return readBin(path, 0x20000, p) == 0x20000;
-}
-
-/*
-	wb_toCit@Cǂݍ
-*/
-static size_t readZ1Bin(const char *path, uint8 *mem, int *ret_top, int *ret_start)
-{
-	size_t size;
-	int top, start;
-	uint8 head[16];
-
-	if((size = readBin(path, 16, head)) == 0)
-		return 0;
-	if(memcmp(head, "\xff\xfe", 2) != 0) {
-		top = start = 0x2000;
-		size = readBin(path, 0x40000 - top, mem + top);
-	} else {
-		top = (head[9] << 8U) | head[8];
-		if((start = (head[13] << 8U) | head[12]) == 0)
-			start = 0x2000;
-
-		if((size = readBin(path, 0x40000 - top - 16, mem + top)) < 16)
-			return 0;
-		memmove(mem + top, mem + top + 16, size - 16);
-		size -= 16;
-	}
-
-	if(ret_top != NULL)
-		*ret_top = top;
-	if(ret_start != NULL)
-		*ret_start = start;
-	return size;
-}
-
-/*
-	oCit@C
-*/
-static size_t writeBin(const char *path, uint8 *p, size_t size)
-{
-	FILE *fp;
-	size_t written;
-
-	if((fp = fopen(path, "wb")) < 0)
-		return 0;
-	written = fwrite(p, 1, size, fp);
-	fclose(fp);
-
-	return written;
+	fprintf(stderr, "%s%dclocks\n\n", i86regs(buf, i86), i86->i.total_states - i86->i.states);
 }
 
 /*
@@ -330,68 +231,509 @@ static int foreCount(Z1stat *z1, struct Timer *t, int addition)
 	return t->control & 0x2000;
 }
 
+/*
+	o̓t@C폜ꂽ? (flushIOPort̉)
+*/
+static int isRemoved(FILE *fp)
+{
+#ifdef _WIN32
+	return FALSE;
+#else
+	struct stat st;
+
+	return fstat(fileno(fp), &st) == 0 && st.st_nlink == 0;
+#endif
+}
+
+/*
+	I/O|[g̃obt@t@Cɏ (ioPortLoop̉)
+*/
+static void flushIOPort(struct IOThread *t, struct IOPort *s)
+{
+	uint8 buf[IOPORT_BUFFER];
+	int len, truncate, reopened = FALSE;
+
+	/* [[͋[[Xbh */
+	if(s->pty)
+		return;
+
+	/* obt@o */
+	len = s->len;
+	truncate = s->truncate;
+	memcpy(buf, s->buf, len);
+	s->len = 0;
+	s->truncate = FALSE;
+	pthread_cond_broadcast(&t->drained);
+	if(len == 0 && !truncate)
+		return;
+
+	/* ̓bNO */
+	pthread_mutex_unlock(&t->mutex);
+	if(truncate) {
+		if(s->fp != NULL)
+			fclose(s->fp);
+		s->fp = fopen(s->path, "wb");
+	} else if(s->fp == NULL || isRemoved(s->fp)) {
+		/* 폜Ă΃I[vȂ */
+		reopened = (s->fp != NULL);
+		if(s->fp != NULL)
+			fclose(s->fp);
+		s->fp = fopen(s->path, "ab");
+	}
+	if(s->fp != NULL) {
+		fwrite(buf, 1, len, s->fp);
+		fflush(s->fp);
+	}
+	pthread_mutex_lock(&t->mutex);
+
+	/* 폜ꂽt@C͐̕Ȃ (񂾕Ɨ܂Ă镪琔Ȃ) */
+	if(reopened && !s->truncate && s->pos > 0)
+		s->pos = len + s->len;
+}
+
+/*
+	o̓Xbh
+*/
+static void *ioPortLoop(void *arg)
+{
+	struct IOThread *t = arg;
+	struct timespec ts;
+	int i;
+
+	pthread_mutex_lock(&t->mutex);
+	while(!t->quit) {
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_nsec += IOPORT_FLUSH_INTERVAL * 1000000L;
+		if(ts.tv_nsec >= 1000000000L) {
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+		pthread_cond_timedwait(&t->cond, &t->mutex, &ts);
+
+		for(i = 0; i < sizeof(t->out_ports) / sizeof(t->out_ports[0]); i++)
+			flushIOPort(t, t->out_ports[i]);
+	}
+
+	/* cŕ */
+	for(i = 0; i < sizeof(t->out_ports) / sizeof(t->out_ports[0]); i++) {
+		flushIOPort(t, t->out_ports[i]);
+		if(t->out_ports[i]->fp != NULL) {
+			fclose(t->out_ports[i]->fp);
+			t->out_ports[i]->fp = NULL;
+		}
+	}
+	pthread_mutex_unlock(&t->mutex);
+	return NULL;
+}
+
+#ifndef _WIN32
+/*
+	[[ɑM (ptyLoop̉)
+*/
+static void writePTY(struct IOThread *t, struct IOPort *s)
+{
+	uint8 buf[IOPORT_BUFFER];
+	int len;
+
+	/* ̓bNO */
+	len = s->len;
+	s->truncate = FALSE;
+	memcpy(buf, s->buf, len);
+	pthread_mutex_unlock(&t->mutex);
+	len = write(t->pty_master, buf, len);
+	pthread_mutex_lock(&t->mutex);
+
+	/* ߂菜 */
+	if(len > 0) {
+		memmove(s->buf, s->buf + len, s->len - len);
+		s->len -= len;
+		pthread_cond_broadcast(&t->drained);
+	}
+}
+
+/*
+	[[M (ptyLoop̉)
+*/
+static void readPTY(struct IOThread *t)
+{
+	uint8 buf[IOPORT_BUFFER];
+	int len;
+
+	/* Ǎ̓bNO */
+	pthread_mutex_unlock(&t->mutex);
+	len = read(t->pty_master, buf, IOPORT_BUFFER - t->pty_rx_len);
+	pthread_mutex_lock(&t->mutex);
+
+	if(len > 0) {
+		memcpy(t->pty_rx + t->pty_rx_len, buf, len);
+		t->pty_rx_len += len;
+	}
+}
+
+/*
+	[[Xbh
+*/
+static void *ptyLoop(void *arg)
+{
+	struct IOThread *t = arg;
+	struct pollfd fds;
+
+	pthread_mutex_lock(&t->mutex);
+	while(!t->quit) {
+		/* Mσf[^ςȂΎMȂ */
+		fds.fd = t->pty_master;
+		fds.events = (t->pty_rx_len < IOPORT_BUFFER ? POLLIN: 0) | (t->pty_ports[0]->len > 0 ? POLLOUT: 0);
+		fds.revents = 0;
+
+		pthread_mutex_unlock(&t->mutex);
+		poll(&fds, 1, IOPORT_FLUSH_INTERVAL / 10);
+		pthread_mutex_lock(&t->mutex);
+
+		if(fds.revents & POLLOUT)
+			writePTY(t, t->pty_ports[0]);
+		if(fds.revents & POLLIN)
+			readPTY(t);
+	}
+	pthread_mutex_unlock(&t->mutex);
+	return NULL;
+}
+
+/*
+	[[̎Mσf[^ǂ݃f[^Ɉڂ (fillIOPort̉)
+*/
+static int fillPTY(struct IOPort *s)
+{
+	struct IOThread *t = s->thread;
+	int len;
+
+	pthread_mutex_lock(&t->mutex);
+	if((len = t->pty_rx_len) > IOPORT_BUFFER - s->in_len)
+		len = IOPORT_BUFFER - s->in_len;
+	memcpy(s->buf + s->in_len, t->pty_rx, len);
+	memmove(t->pty_rx, t->pty_rx + len, t->pty_rx_len - len);
+	t->pty_rx_len -= len;
+	pthread_mutex_unlock(&t->mutex);
+
+	s->in_len += len;
+	return len > 0;
+}
+
+/*
+	[[ (stopIOPort̉)
+*/
+static void closePTY(struct IOThread *t)
+{
+	if(t->pty_link != NULL)
+		unlink(t->pty_link);
+	if(t->pty_slave >= 0)
+		close(t->pty_slave);
+	if(t->pty_master >= 0)
+		close(t->pty_master);
+	t->pty_slave = t->pty_master = -1;
+}
+
+/*
+	[[J (initIOPort̉)
+*/
+static int openPTY(Z1stat *z1)
+{
+	struct IOThread *t = &z1->io_thread;
+	struct termios tio;
+	char name[PATH_MAX];
+
+	/* ptsname͐ÓIȗ̈Ԃ̂ŕ̃}VgȂ */
+	if((t->pty_master = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(t->pty_master) < 0 || unlockpt(t->pty_master) < 0 || ptsname_r(t->pty_master, name, sizeof(name)) != 0) {
+		fprintf(stderr, "posix_openpt fail.\n");
+		return FALSE;
+	}
+
+	/* 肪ĂEIOɂȂȂ悤ɃX[uJĂ */
+	if((t->pty_slave = open(name, O_RDWR | O_NOCTTY)) < 0) {
+		fprintf(stderr, "%s: open fail.\n", name);
+		return FALSE;
+	}
+
+	/* ϊGR[Ȃ */
+	if(tcgetattr(t->pty_slave, &tio) == 0) {
+		cfmakeraw(&tio);
+		tcsetattr(t->pty_slave, TCSANOW, &tio);
+	}
+	fcntl(t->pty_master, F_SETFL, fcntl(t->pty_master, F_GETFL) | O_NONBLOCK);
+
+	/* V{bNN */
+	if(strcmp(z1->setting.path_pty_link, "") != 0) {
+		unlink(z1->setting.path_pty_link);
+		if(symlink(name, z1->setting.path_pty_link) < 0)
+			fprintf(stderr, "%s: symlink fail.\n", z1->setting.path_pty_link);
+		else
+			t->pty_link = z1->setting.path_pty_link;
+	}
+	/* Wo͂͌ʂ̏o͂Ɏg邱Ƃ̂ŕWG[o͂ɏ */
+	fprintf(stderr, "sio: %s\n", name);
+
+	/* VA|[g[[ɐڑ */
+	setIOData(&z1->rs_send, name);
+	setIOData(&z1->rs_receive, name);
+	z1->rs_send.pty = z1->rs_receive.pty = TRUE;
+	t->pty_ports[0] = &z1->rs_send;
+	t->pty_ports[1] = &z1->rs_receive;
+	return TRUE;
+}
+#endif
+
+/*
+	o̓XbhI
+*/
+void stopIOPort(Z1stat *z1)
+{
+	struct IOThread *t = &z1->io_thread;
+
+	if(!t->started)
+		return;
+
+	pthread_mutex_lock(&t->mutex);
+	t->quit = TRUE;
+	pthread_cond_signal(&t->cond);
+	pthread_mutex_unlock(&t->mutex);
+	pthread_join(t->thread, NULL);
+#ifndef _WIN32
+	if(t->pty_started)
+		pthread_join(t->pty_thread, NULL);
+	closePTY(t);
+#endif
+	pthread_mutex_destroy(&t->mutex);
+	pthread_cond_destroy(&t->cond);
+	pthread_cond_destroy(&t->drained);
+	t->started = FALSE;
+}
+
+/*
+	o̓XbhJn
+*/
+int initIOPort(Z1stat *z1)
+{
+	struct IOThread *t = &z1->io_thread;
+
+	pthread_mutex_init(&t->mutex, NULL);
+	pthread_cond_init(&t->cond, NULL);
+	pthread_cond_init(&t->drained, NULL);
+	t->quit = FALSE;
+	t->out_ports[0] = &z1->rs_send;
+	t->out_ports[1] = &z1->printer;
+	z1->rs_send.thread = z1->printer.thread = z1->rs_receive.thread = t;
+
+#ifndef _WIN32
+	t->pty_master = t->pty_slave = -1;
+	if(z1->setting.sio_pty && !openPTY(z1)) {
+		closePTY(t);
+		return FALSE;
+	}
+#else
+	if(z1->setting.sio_pty)
+		fprintf(stderr, "sio_pty: not supported.\n");
+#endif
+
+	if(pthread_create(&t->thread, NULL, ioPortLoop, t) != 0) {
+		fprintf(stderr, "pthread_create fail.\n");
+		return FALSE;
+	}
+	t->started = TRUE;
+#ifndef _WIN32
+	if(t->pty_master >= 0) {
+		if(pthread_create(&t->pty_thread, NULL, ptyLoop, t) != 0) {
+			fprintf(stderr, "pthread_create fail.\n");
+			return FALSE;
+		}
+		t->pty_started = TRUE;
+	}
+#endif
+	return TRUE;
+}
+
+/*
+	o͂1oCgɗ߂ (sendIODatả)
+*/
+static int keepIOData(struct IOPort *s, uint8 data)
+{
+	uint8 *kept;
+	int size;
+
+	/* ŏ̏o͂ȂΎ̂Ă */
+	if(s->pos <= 0) {
+		s->pos = 0;
+		s->kept_len = 0;
+	}
+
+	/* obt@tȂΑ傫 */
+	if(s->kept_len >= s->kept_size) {
+		size = (s->kept_size == 0 ? IOPORT_BUFFER: s->kept_size * 2);
+		if((kept = realloc(s->kept, size)) == NULL)
+			return FALSE;
+		s->kept = kept;
+		s->kept_size = size;
+	}
+
+	s->kept[s->kept_len++] = data;
+	s->pos++;
+	return TRUE;
+}
+
 /*
 	I/O|[g1oCgo͂
 */
 int sendIOData(struct IOPort *s, uint8 data)
 {
-	FILE *fp;
-	size_t size;
-	char buf[256];
+	struct IOThread *t = s->thread;
 
+	/* ɗ߂ȂΏXbhgȂ */
+	if(s->keep)
+		return keepIOData(s, data);
+
+	pthread_mutex_lock(&t->mutex);
+
+	/* ŏ̏o͂Ȃ΃t@C蒼 */
 	if(s->pos <= 0) {
 		s->pos = 0;
-		unlink(s->path);
+		s->len = 0;
+		s->truncate = TRUE;
 	}
 
-	if((fp = fopen(s->path, "rb")) == NULL)
-		s->pos = 0;
-	else
-		fclose(fp);
+	/* [[͑肪ǂ܂ȂΎ̂Ă */
+	if(s->pty && s->len >= IOPORT_BUFFER) {
+		s->pos++;
+		pthread_mutex_unlock(&t->mutex);
+		return FALSE;
+	}
+
+	/* obt@ςȂΏ҂ */
+	while(s->len >= IOPORT_BUFFER) {
+		pthread_cond_signal(&t->cond);
+		pthread_cond_wait(&t->drained, &t->mutex);
+	}
+
+	s->buf[s->len++] = data;
+	s->pos++;
+	if(s->len >= IOPORT_BUFFER / 2)
+		pthread_cond_signal(&t->cond);
+
+	pthread_mutex_unlock(&t->mutex);
+	return TRUE;
+}
+
+/*
+	̓t@CI[v (fillIOPort̉)
+*/
+static FILE *openInput(const char *path)
+{
+#ifdef _WIN32
+	return fopen(path, "rb");
+#else
+	int fd;
+
+	/* OtpCvł҂Ȃ悤ɂ */
+	if((fd = open(path, O_RDONLY | O_NONBLOCK)) < 0)
+		return NULL;
+	return fdopen(fd, "rb");
+#endif
+}
+
+/*
+	̓t@Cuꂽ? (fillIOPort̉)
+*/
+static int isReplaced(const char *path, FILE *fp)
+{
+#ifdef _WIN32
+	return FALSE;
+#else
+	struct stat st_path, st_fp;
 
-	if((fp = fopen(s->path, "ab")) == NULL)
+	if(stat(path, &st_path) < 0 || fstat(fileno(fp), &st_fp) < 0)
 		return FALSE;
-	if((size = fwrite(&data, 1, 1, fp)) > 0)
-		s->pos += size;
-	fclose(fp);
+	return st_path.st_dev != st_fp.st_dev || st_path.st_ino != st_fp.st_ino;
+#endif
+}
+
+/*
+	̓t@Cǂ݂ (peekIODatả)
+*/
+static int fillIOPort(struct IOPort *s)
+{
+	FILE *fp;
+	int len, off;
+
+	/* ɒBĂΎ̎܂ő҂ */
+	if(s->eof)
+		return FALSE;
+
+	/* ǂݏIf[^̂Ă */
+	if((off = s->pos - s->in_top) > 0) {
+		memmove(s->buf, s->buf + off, s->in_len - off);
+		s->in_top = s->pos;
+		s->in_len -= off;
+	}
+
+#ifndef _WIN32
+	/* [[XbhMf[^󂯎 */
+	if(s->pty)
+		return fillPTY(s);
+#endif
+
+	/* I[v */
+	if(s->in == NULL || isReplaced(s->path, s->in)) {
+		if(s->in != NULL)
+			fclose(s->in);
+		if((s->in = openInput(s->path)) == NULL) {
+			if((fp = fopen(s->path, "wb")) != NULL)
+				fclose(fp);
+			s->eof = TRUE;
+			return FALSE;
+		}
+		s->in_top = s->pos;
+		s->in_len = 0;
+		if(s->pos > 0)
+			lseek(fileno(s->in), s->pos, SEEK_SET);
+	}
+
+	/* ǂݍ */
+	if((len = read(fileno(s->in), s->buf + s->in_len, IOPORT_BUFFER - s->in_len)) <= 0) {
+		s->eof = TRUE;
+		return FALSE;
+	}
+	s->in_len += len;
+	return TRUE;
+}
 
-	sprintf(buf, "%s %dbytes", s->path, s->pos);
-	setTitle(buf);
-	return size > 0;
+/*
+	I/O|[g̖̓͂mFȂ, Mn߂܂ł̎𐔂 (1)
+*/
+void pollIOData(struct IOPort *s)
+{
+	s->eof = FALSE;
+	if(s->pos < 0)
+		s->pos++;
 }
 
 /*
 	I/O|[gMf[^𓾂(|C^͐i߂Ȃ)
+	sPʂƂɌĂ΂̂, Mn߂܂ł̎͂ł͐Ȃ
 */
 int peekIOData(struct IOPort *s, uint8 *data)
 {
-	FILE *fp;
-	size_t size;
 	uint8 dummy;
 
-	if(s->pos < 0) {
-		s->pos++;
+	if(s->pos < 0)
 		return FALSE;
-	}
 
 	if(data == NULL)
 		data = &dummy;
 
 	*data = 0;
 
-	if((fp = fopen(s->path, "rb")) == NULL) {
-		if((fp = fopen(s->path, "wb")) != NULL)
-			fclose(fp);
+	if(s->pos - s->in_top >= s->in_len && !fillIOPort(s))
 		return FALSE;
-	}
-
-	if(fseek(fp, s->pos, SEEK_SET) > 0)
-		size = fread(data, 1, 1, fp);
-	else
-		size = 0;
 
-	fclose(fp);
-	return size > 0;
+	*data = s->buf[s->pos - s->in_top];
+	return TRUE;
 }
 
 /*
@@ -399,14 +741,9 @@ int peekIOData(struct IOPort *s, uint8 *data)
 */
 int receiveIOData(struct IOPort *s, uint8 *data)
 {
-	char buf[256];
-
 	if(!peekIOData(s, data))
 		return FALSE;
 	s->pos++;
-
-	sprintf(buf, "%s %dbytes", s->path, s->pos);
-	setTitle(buf);
 	return TRUE;
 }
 
@@ -503,6 +840,93 @@ uint8 *encodeMan(uint8 *bcd, int64 man)
 	return bcd;
 }
 
+/* 14 */
+#define MAN_MASK	0x00ffffffffffffffULL	/* S */
+#define MAN_SIXES	0x0066666666666666ULL	/* S6 */
+#define MAN_NINES	0x0099999999999999ULL	/* S9 */
+#define MAN_CARRIES	0x0111111111111110ULL	/* ěオ */
+
+/*
+	BCD̉64rbgœǂݍ (opXỶ)
+*/
+static uint64 loadMan(const uint8 *bcd)
+{
+	uint64 m, invalid;
+
+	m =
+	(uint64 )bcd[0] |
+	(uint64 )bcd[1] << 8 |
+	(uint64 )bcd[2] << 16 |
+	(uint64 )bcd[3] << 24 |
+	(uint64 )bcd[4] << 32 |
+	(uint64 )bcd[5] << 40 |
+	(uint64 )bcd[6] << 48;
+
+	/* A-F̌0Ƃ (decodeBCDƓ) */
+	invalid = (m >> 3) & ((m >> 2) | (m >> 1)) & 0x0011111111111111ULL;
+	return m & ~(invalid * 0x0f);
+}
+
+/*
+	64rbg̉BCDɏ (opXỶ)
+*/
+static uint8 *storeMan(uint8 *bcd, uint64 m)
+{
+	bcd[0] = m;
+	bcd[1] = m >> 8;
+	bcd[2] = m >> 16;
+	bcd[3] = m >> 24;
+	bcd[4] = m >> 32;
+	bcd[5] = m >> 40;
+	bcd[6] = m >> 48;
+
+	return bcd;
+}
+
+/*
+	Z (opXỶ)
+*/
+static uint64 addMan(uint64 x, uint64 y, uint8 *carry)
+{
+	uint64 t1, t2, t6;
+
+	/* e6𑫂2iŉZ, オ肵Ȃ6 */
+	t1 = x + MAN_SIXES;
+	t2 = t1 + y;
+	t6 = ~(t2 ^ t1 ^ y) & MAN_CARRIES;
+	t6 = (t6 >> 2) | (t6 >> 3);
+
+	*carry = (t2 >> 56) & 1;
+	return (t2 - t6) & MAN_MASK;
+}
+
+/*
+	Z (opXỶ)
+*/
+static uint64 subMan(uint64 x, uint64 y, uint8 *borrow)
+{
+	uint8 c1, c2;
+	uint64 a;
+
+	/* x + (99...9 - y) + 1 ӂꂵȂΎ؂肪 */
+	a = addMan(x, MAN_NINES - y, &c1);
+	a = addMan(a, 1, &c2);
+
+	*borrow = !(c1 | c2);
+	return a;
+}
+
+/*
+	Vtg
+*/
+uint8 *shiftMan(uint8 *bcd, int left)
+{
+	if(left) /* 10{ */
+		return storeMan(bcd, (loadMan(bcd) << 4) & MAN_MASK);
+	else /* 101 */
+		return storeMan(bcd, loadMan(bcd) >> 4);
+}
+
 /*
 	l̎wEݒ肷 (opXỶ)
 */
@@ -546,7 +970,6 @@ static uint8 *encodeSgn(uint8 *bcd, int s)
 */
 void opXY(uint8 op, const uint8 *x, const uint8 *y, uint8 *a, uint8 *f)
 {
-	int64 a_man;
 	int a_exp;
 	const uint8 zero[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
 
@@ -563,45 +986,25 @@ void opXY(uint8 op, const uint8 *x, const uint8 *y, uint8 *a, uint8 *f)
 	case 0x00: /* X + Y */
 		encodeExpSgn(a, (decodeExpSgn(a) + decodeExpSgn(y)) % 10000);
 	case 0x40: /*  X + Y */
-		if((a_man = decodeMan(a) + decodeMan(y)) > 99999999999999LL) {
-			a_man -= 100000000000000LL;
-			*f = 1;
-		} else
-			*f = 0;
-		encodeMan(a, a_man);
+		storeMan(a, addMan(loadMan(a), loadMan(y), f));
 		break;
 
 	case 0x01: /* X - Y */
 		encodeExpSgn(a, (10000 + decodeExpSgn(a) - decodeExpSgn(y)) % 10000);
 	case 0x41: /*  X - Y */
-		if((a_man = decodeMan(a) - decodeMan(y)) < 0LL) {
-			a_man += 100000000000000LL;
-			*f = 1;
-		} else
-			*f = 0;
-		encodeMan(a, a_man);
+		storeMan(a, subMan(loadMan(a), loadMan(y), f));
 		break;
 
 	case 0x02: /* Y + X */
 		encodeExpSgn(a, (decodeExpSgn(a) + decodeExpSgn(x)) % 10000);
 	case 0x42: /*  Y + X */
-		if((a_man = decodeMan(a) + decodeMan(x)) > 99999999999999LL) {
-			a_man -= 100000000000000LL;
-			*f = 1;
-		} else
-			*f = 0;
-		encodeMan(a, a_man);
+		storeMan(a, addMan(loadMan(a), loadMan(x), f));
 		break;
 
 	case 0x03: /* Y - X */
 		encodeExpSgn(a, (10000 + decodeExpSgn(a) - decodeExpSgn(x)) % 10000);
 	case 0x43: /*  Y - X */
-		if((a_man = decodeMan(a) - decodeMan(x)) < 0LL) {
-			a_man += 100000000000000LL;
-			*f = 1;
-		} else
-			*f = 0;
-		encodeMan(a, a_man);
+		storeMan(a, subMan(loadMan(a), loadMan(x), f));
 		break;
 
 	case 0x10: /* w X + 1 */
@@ -649,6 +1052,20 @@ void opXY(uint8 op, const uint8 *x, const uint8 *y, uint8 *a, uint8 *f)
 		*f |= 0x40;
 }
 
+/*
+	Zʂ𓾂 (X, Y, ZςĂȂΑǑʂ߂)
+*/
+const uint8 *getCalResult(Z1stat *z1, uint8 *f)
+{
+	if(!z1->cal.valid) {
+		opXY(z1->cal.op, &z1->memory[0x0400], &z1->memory[0x0410], z1->cal.a, &z1->cal.f);
+		z1->cal.valid = TRUE;
+	}
+	if(f != NULL)
+		*f = z1->cal.f;
+	return z1->cal.a;
+}
+
 /*
 	WX^̒l𕶎ɕϊ
 */
@@ -727,101 +1144,194 @@ char *decodeValue(char *text, const uint8 *value)
 }
 
 /*
-	obt@ɏ
+	uU[̕ωL^
 */
 void writeSound(Z1stat *z1, uint8 buzzer)
 {
 	struct Sound *sound = &z1->sound;
-	long long states;
-	int pos;
-	int8 *sound_buffer;
+	struct SoundEvent *event;
+	uint64 now;
+	int8 vol = sound->last_vol;
+
+	if(sound->mix == NULL)
+		return;
 
-	if(sound->len == 0)
+	if(buzzer & 0x02)
+		vol = vol < 0 ? 16: -16;
+	if(!(buzzer & 0x01))
+		vol = 0;
+	if(vol == sound->last_vol)
 		return;
+	sound->last_vol = vol;
+
+	/* L^ȂƂ͍Ō̕ωu */
+	if(sound->event_count < SOUND_EVENTS)
+		event = &sound->event[sound->event_count++];
+	else
+		event = &sound->event[SOUND_EVENTS - 1];
+
+	now = z1->slice_end - z1->cpu.i.states;
+	event->states = (now > sound->frame_states ? (uint32 )(now - sound->frame_states): 0);
+	event->vol = vol;
+}
 
-	/*
-	states = (z1->cpu.i.total_states - z1->cpu.i.states) % (z1->setting.cpu_clock / z1->setting.refresh_rate);
-	pos = AUDIO_RATE * states / z1->setting.cpu_clock;
-	*/
-	states = MIN(MAX(z1->cpu.i.total_states - sound->last_states - z1->cpu.i.states, 0), z1->setting.cpu_clock / z1->setting.refresh_rate);
-	pos = AUDIO_RATE * states / z1->setting.cpu_clock;
-	sound_buffer = sound->buffer[sound->page == 0];
 /*
-	printf("states=%d, pos=%d (%d%%), buzzer=%02x\n", (int )states, pos, pos * 100 / sound->len, buzzer);
+	{[̕ωш搧ĉ (renderSound̉)
 */
+static void addBLEP(float *buf, int len, double pos, float step, float *carry)
+{
+	int n = (int )pos;
+	double a, b;
+
+	/* ω̒ÕTv */
+	b = pos - n;
+	if(b > 0.0 && n < len)
+		buf[n] += step * (float )((1.0 - b) * (1.0 - b) / 2.0);
+
+	/* ω̒̃Tv */
+	if(b > 0.0)
+		n++;
+	a = n - pos;
+	if(n < len)
+		buf[n] -= step * (float )((1.0 - a) * (1.0 - a) / 2.0);
+	else
+		*carry -= step * (float )((1.0 - a) * (1.0 - a) / 2.0);
+}
+
 /*
-	pos = (pos / 8) * 8;
-	if(sound->last_pos == pos || sound->last_pos == pos + 1 || sound->last_pos == pos + 2 || sound->last_pos == pos + 3 || sound->last_pos == pos + 4 || sound->last_pos == pos + 5 || sound->last_pos == pos + 6 || sound->last_pos == pos + 7)
-		pos += 8;
-	else if(sound->last_pos == pos + 8 || sound->last_pos == pos + 9 || sound->last_pos == pos + 10 || sound->last_pos == pos + 11 || sound->last_pos == pos + 12 || sound->last_pos == pos + 13 || sound->last_pos == pos + 14 || sound->last_pos == pos + 15)
-		pos += 16;
+	1t[̉𐶐Ę^, Oobt@ɏ (flipSoundBuffer̉)
 */
-	if(pos == sound->last_pos)
-		pos++;
-	else if(pos + 1 == sound->last_pos)
-		pos += 2;
-	sound->last_pos = pos;
-	if(pos < 0)
-		pos = 0;
+static void renderSound(Z1stat *z1, int len)
+{
+	struct Sound *sound = &z1->sound;
+	const struct SoundEvent *event;
+	float *buf = sound->mix, vol = sound->frame_vol, v;
+	double pos, top;
+	unsigned int w, free;
+	int i, n;
+
+	/* ω̂тɊKiɖ, ω_̑O␳ */
+	for(i = 0; i < len; i++)
+		buf[i] = 0.0f;
+	buf[0] = sound->carry;
+	sound->carry = 0.0f;
+
+	top = (double )sound->frame_states * AUDIO_RATE / z1->setting.cpu_clock - sound->frame_sample;
+	for(i = 0, event = sound->event; event < sound->event + sound->event_count; event++) {
+		pos = top + (double )event->states * AUDIO_RATE / z1->setting.cpu_clock;
+		if(pos < 0.0)
+			pos = 0.0;
+		else if(pos > len - 1)
+			pos = len - 1;
+		for(n = (int )pos + (pos > (int )pos); i < n; i++)
+			buf[i] += vol;
+		addBLEP(buf, len, pos, event->vol - vol, &sound->carry);
+		vol = event->vol;
+	}
+	for(; i < len; i++)
+		buf[i] += vol;
 
-	if(buzzer & 0x02)
-		sound->last_vol = sound->last_vol < 0 ? 16: -16;
-	if(!(buzzer & 0x01))
-		sound->last_vol = 0;
-	if(pos < sound->len)
-		memset(sound_buffer + pos, sound->last_vol, sound->len - pos);
+	for(i = 0; i < len; i++) {
+		v = (buf[i] < 0.0f ? buf[i] - 0.5f: buf[i] + 0.5f);
+		sound->pcm[i] = (int8 )MAX(MIN((int )v, 127), -128);
+	}
+	recordSound(z1, sound->pcm, len);
+
+	/* ^[{͖炳Ȃ */
+	if(sound->len == 0 || z1->turbo.on)
+		return;
+
+	/* 󂢂Ă镪 */
+	w = atomic_load_explicit(&sound->write, memory_order_relaxed);
+	free = sound->size - (w - atomic_load_explicit(&sound->read, memory_order_acquire));
+	if(len > free) {
+		atomic_fetch_add_explicit(&sound->overrun, len - free, memory_order_relaxed);
+		len = free;
+	}
+	for(i = 0; i < len; i++)
+		sound->ring[(w + i) & (sound->size - 1)] = sound->pcm[i];
+	atomic_store_explicit(&sound->write, w + len, memory_order_release);
 }
 
 /*
-	TEhobt@؂ւ
+	t[̉Oobt@ɑ
 */
 void flipSoundBuffer(Z1stat *z1)
 {
 	struct Sound *sound = &z1->sound;
+	uint64 end;
+	int len;
 
-	if(sound->len == 0)
+	if(sound->mix == NULL)
 		return;
+
+	/* Õt[̏I肩獡܂ł̃Tv */
+	end = z1->elapsed_states * AUDIO_RATE / z1->setting.cpu_clock;
+	len = (int )MIN(end - sound->frame_sample, (uint64 )sound->mix_len);
+	if(len > 0)
+		renderSound(z1, len);
+
+	sound->frame_states = z1->elapsed_states;
+	sound->frame_sample = end;
+	sound->frame_vol = sound->last_vol;
+	sound->event_count = 0;
+}
+
 /*
-	while(!sound->played)
-		SDL_Delay(0);
+	Oobt@̎c̃Tv𓾂
 */
+int getSoundFill(struct Sound *sound)
+{
+	return (int )(atomic_load_explicit(&sound->write, memory_order_acquire) - atomic_load_explicit(&sound->read, memory_order_acquire));
+}
 
-#if 0
-	{
-		uint8 buf[16384], *p;
-		int8 *q;
+/*
+	Oobt@Tvǂݍ (ĐĂ)
+*/
+int getSound(struct Sound *sound, int8 *buf, int len)
+{
+	unsigned int r, avail;
+	int i, n;
 
-		for(p = buf, q = sound->buffer[sound->page == 0]; p < buf + sound->len; p++, q++) {
-			*p = (int )*q + 128;
-		}
-		appendWave("sound.wav", buf, sound->len);
-		printf("\n");
-	}
-#endif
+	r = atomic_load_explicit(&sound->read, memory_order_relaxed);
+	avail = atomic_load_explicit(&sound->write, memory_order_acquire) - r;
+	n = (len < avail ? len: (int )avail);
+	for(i = 0; i < n; i++)
+		buf[i] = sound->ring[(r + i) & (sound->size - 1)];
+	atomic_store_explicit(&sound->read, r + n, memory_order_release);
+
+	if(n > 0)
+		sound->last_sample = buf[n - 1];
 
-	memset(sound->buffer[sound->page], sound->last_vol, sound->len);
-	sound->page = (sound->page == 0);
-	sound->last_states = z1->cpu.i.total_states;
-	sound->last_pos = INT_MIN;
-	sound->played = FALSE;
+	/* ȂƂ͍Ō̃Tv𑱂 */
+	if(n < len) {
+		atomic_fetch_add_explicit(&sound->underrun, 1, memory_order_relaxed);
+		memset(buf + n, sound->last_sample, len - n);
+	}
+	return n;
 }
 
 /*
-	LCDXV
+	LCD̎c1t[̕ωʂ𓾂
 */
-static void updateLCD(Z1stat *z1)
+int getLCDFade(const Z1stat *z1)
 {
-	int d, *p;
-	const uint8 *v;
-
-	/* LCDXV */
 	if(z1->setting.scales == 2)
-		d = 255;
+		return 255;
 	else
-		d = 256 / (z1->setting.refresh_rate / 10);
+		return 256 / (z1->setting.refresh_rate / 10);
+}
 
-	p = z1->lcd.pix;
-	for(v = z1->vram.vram; v < z1->vram.vram + LCD_HEIGHT * LCD_WIDTH / 8; v++) {
+/*
+	LCD̔ZxcčXV
+*/
+void fadeLCD(struct Lcd *lcd, const uint8 *vram, uint8 status, int d)
+{
+	int *p;
+	const uint8 *v;
+
+	p = lcd->pix;
+	for(v = vram; v < vram + LCD_HEIGHT * LCD_WIDTH / 8; v++) {
 		if(*v & 0x80) *p = MIN(*p + d, 255); else *p = MAX(*p - d, 0);
 		p++;
 		if(*v & 0x40) *p = MIN(*p + d, 255); else *p = MAX(*p - d, 0);
@@ -839,14 +1349,12 @@ static void updateLCD(Z1stat *z1)
 		if(*v & 0x01) *p = MIN(*p + d, 255); else *p = MAX(*p - d, 0);
 		p++;
 	}
-	if(z1->vram.status & 0x01) z1->lcd.symbol[0] = MIN(z1->lcd.symbol[0] + d, 255); else z1->lcd.symbol[0] = MAX(z1->lcd.symbol[0] - d, 0); /* CAPS */
-	if(z1->vram.status & 0x04) z1->lcd.symbol[1] = MIN(z1->lcd.symbol[1] + d, 255); else z1->lcd.symbol[1] = MAX(z1->lcd.symbol[1] - d, 0); /* S */
-	if(z1->vram.status & 0x08) z1->lcd.symbol[2] = MIN(z1->lcd.symbol[2] + d, 255); else z1->lcd.symbol[2] = MAX(z1->lcd.symbol[2] - d, 0); /* BASIC */
-	if(z1->vram.status & 0x10) z1->lcd.symbol[3] = MIN(z1->lcd.symbol[3] + d, 255); else z1->lcd.symbol[3] = MAX(z1->lcd.symbol[3] - d, 0); /* DEG */
-	if(z1->vram.status & 0x20) z1->lcd.symbol[4] = MIN(z1->lcd.symbol[4] + d, 255); else z1->lcd.symbol[4] = MAX(z1->lcd.symbol[4] - d, 0); /* RAD */
-	if(z1->vram.status & 0x80) z1->lcd.symbol[5] = MIN(z1->lcd.symbol[5] + d, 255); else z1->lcd.symbol[5] = MAX(z1->lcd.symbol[5] - d, 0); /* GRA */
-
-	updateWindow(z1);
+	if(status & 0x01) lcd->symbol[0] = MIN(lcd->symbol[0] + d, 255); else lcd->symbol[0] = MAX(lcd->symbol[0] - d, 0); /* CAPS */
+	if(status & 0x04) lcd->symbol[1] = MIN(lcd->symbol[1] + d, 255); else lcd->symbol[1] = MAX(lcd->symbol[1] - d, 0); /* S */
+	if(status & 0x08) lcd->symbol[2] = MIN(lcd->symbol[2] + d, 255); else lcd->symbol[2] = MAX(lcd->symbol[2] - d, 0); /* BASIC */
+	if(status & 0x10) lcd->symbol[3] = MIN(lcd->symbol[3] + d, 255); else lcd->symbol[3] = MAX(lcd->symbol[3] - d, 0); /* DEG */
+	if(status & 0x20) lcd->symbol[4] = MIN(lcd->symbol[4] + d, 255); else lcd->symbol[4] = MAX(lcd->symbol[4] - d, 0); /* RAD */
+	if(status & 0x80) lcd->symbol[5] = MIN(lcd->symbol[5] + d, 255); else lcd->symbol[5] = MAX(lcd->symbol[5] - d, 0); /* GRA */
 }
 
 /*
@@ -1041,28 +1549,189 @@ static char *getPath(const struct Disk *disk, char *path, const uint8 *fd_file)
 	return path;
 }
 
-/*
-	t@C̑𓾂
-*/
-static uint8 getFileAttr(const char *path)
-{
-	FILE *fp;
-	uint8 buf[8];
+/*
+	t@C̑𓾂
+*/
+static uint8 getFileAttr(const char *path)
+{
+	FILE *fp;
+	uint8 buf[8];
+
+	if((fp = fopen(path, "rb")) == NULL)
+		return '?';
+	memset(buf, 0, 2);
+	fread(buf, 1, 2, fp);
+	fclose(fp);
+
+	return (memcmp(buf, "\xff\xfe", 2) == 0 ? 'B': 'A');
+}
+
+/*
+	tbs[fBXN̍𖳌ɂ
+*/
+static void invalidateFdIndex(struct Disk *disk)
+{
+	disk->index_valid = FALSE;
+}
+
+#ifndef _WIN32
+/*
+	tbs[fBXÑt@C̃nbVl𓾂 (̉)
+*/
+static uint32 hashFdFile(const uint8 *file)
+{
+	uint32 h = 2166136261U;
+	int i;
+
+	for(i = 0; i < 11; i++)
+		h = (h ^ file[i]) * 16777619U;
+	return h;
+}
+
+/*
+	t@CT
+*/
+static const struct FdEntry *lookupFdIndex(const struct Disk *disk, const uint8 *file)
+{
+	uint32 i;
+
+	if(disk->hash_size == 0)
+		return NULL;
+	for(i = hashFdFile(file) & (disk->hash_size - 1); disk->hash[i] >= 0; i = (i + 1) & (disk->hash_size - 1))
+		if(memcmp(disk->entries[disk->hash[i]].file, file, 11) == 0)
+			return &disk->entries[disk->hash[i]];
+	return NULL;
+}
+
+/*
+	ŐV? (updateFdIndex̉)
+*/
+static int checkFdIndex(struct Disk *disk, const char *dir, struct stat *st)
+{
+#ifdef __linux__
+	uint8 buf[4096];
+#endif
+
+	if(!disk->index_valid || strcmp(disk->index_dir, dir) != 0)
+		return FALSE;
+
+#ifdef __linux__
+	/* ĎĂ΃CxgȂ΍ŐV */
+	if(disk->inotify >= 0) {
+		if(read(disk->inotify, buf, sizeof(buf)) > 0) {
+			/* c̃Cxgǂݎ̂Ă */
+			while(read(disk->inotify, buf, sizeof(buf)) > 0)
+				;
+			return FALSE;
+		}
+		return TRUE;
+	}
+#endif
+
+	/* ĎĂȂ΍XVׂ */
+	return stat(dir, st) == 0 && st->st_mtime == disk->index_mtime;
+}
+
+/*
+	tbs[fBXN̍쐬
+*/
+static int updateFdIndex(struct Disk *disk)
+{
+	char path[PATH_MAX], dir[PATH_MAX];
+	DIR *d;
+	struct dirent *f;
+	struct stat s, st;
+	struct FdEntry *e, *entries;
+	uint32 i;
+	int n = 0, *hash, hash_size;
+
+	setHomeDir(dir, disk->dir);
+	st.st_mtime = 0;
+	if(checkFdIndex(disk, dir, &st))
+		return TRUE;
+
+	/* fBNgĎ */
+#ifdef __linux__
+	if(strcmp(disk->index_dir, dir) != 0 && disk->inotify >= 0) {
+		close(disk->inotify);
+		disk->inotify = -1;
+	}
+	if(disk->inotify < 0 && (disk->inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) >= 0)
+		if(inotify_add_watch(disk->inotify, dir, IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF) < 0) {
+			close(disk->inotify);
+			disk->inotify = -1;
+		}
+#endif
+	strcpy(disk->index_dir, dir);
+	if(stat(dir, &st) < 0 || (d = opendir(dir)) == NULL) {
+		disk->index_valid = FALSE;
+		return FALSE;
+	}
+
+	/* ڂǂݍ */
+	for(f = readdir(d); f != NULL; f = readdir(d)) {
+		if(f->d_type == DT_DIR || f->d_name[0] == '.')
+			continue;
+
+		if(snprintf(path, sizeof(path), "%s/%s", dir, f->d_name) >= (int )sizeof(path))
+			continue;
+		if(stat(path, &s) < 0 || s.st_size > 0xffffffff)
+			continue;
+
+		if(n % 64 == 0) {
+			if((entries = realloc(disk->entries, sizeof(*disk->entries) * (n + 64))) == NULL) {
+				closedir(d);
+				goto error;
+			}
+			disk->entries = entries;
+		}
+		e = &disk->entries[n];
+		if(!getFdFile(e->file, f->d_name))
+			continue;
+		e->size = s.st_size;
+		e->attr = (s.st_size == 0 ? 'A': getFileAttr(path));
+		n++;
+	}
+	closedir(d);
+	disk->entry_count = n;
+
+	/* nbV\ */
+	for(hash_size = 16; hash_size < n * 2; hash_size *= 2)
+		;
+	if((hash = realloc(disk->hash, sizeof(*disk->hash) * hash_size)) == NULL)
+		goto error;
+	disk->hash = hash;
+	disk->hash_size = hash_size;
+	memset(disk->hash, 0xff, sizeof(*disk->hash) * disk->hash_size);
+	for(n = 0; n < disk->entry_count; n++) {
+		for(i = hashFdFile(disk->entries[n].file) & (disk->hash_size - 1); disk->hash[i] >= 0; i = (i + 1) & (disk->hash_size - 1))
+			;
+		disk->hash[i] = n;
+	}
 
-	if((fp = fopen(path, "rb")) < 0)
-		return '?';
-	memset(buf, 0, 2);
-	fread(buf, 1, 2, fp);
-	fclose(fp);
+	/* b̂ɍXVꂽȂΎȂ */
+	disk->index_mtime = st.st_mtime;
+	disk->index_valid = (disk->inotify >= 0 || st.st_mtime < time(NULL));
+	return TRUE;
 
-	return (memcmp(buf, "\xff\xfe", 2) == 0 ? 'B': 'A');
+error:;
+	/* Ȃ΋̍ƂĎȂ */
+	disk->entry_count = 0;
+	if(disk->hash != NULL)
+		memset(disk->hash, 0xff, sizeof(*disk->hash) * disk->hash_size);
+	disk->index_valid = FALSE;
+	return FALSE;
 }
+#endif
 
 /*
 	tbs[fBXN̋󂫗eʂ𓾂
 */
 uint8 getFdFreeSize(struct Disk *disk, uint32 *size)
 {
+	if(disk->image != NULL)
+		return getFdImageFreeSize(disk, size);
+
 #ifdef WIN32
 	ULARGE_INTEGER free, avail, total;
 	wchar_t wdir[PATH_MAX], wroot[PATH_MAX], *wfile;
@@ -1097,6 +1766,59 @@ uint8 getFdFreeSize(struct Disk *disk, uint32 *size)
 	return 0x00;
 }
 
+/*
+	tbs[fBXÑt@C̏obt@o ()
+*/
+static int flushFdFile(struct Disk *disk)
+{
+	size_t len = disk->buf_len;
+
+	disk->buf_len = 0;
+	return fwrite(disk->buf, 1, len, disk->fp) == len;
+}
+
+/*
+	tbs[fBXÑt@C ()
+*/
+static int closeFd(struct Disk *disk)
+{
+	int ok = TRUE;
+
+	if(disk->writing) {
+		ok = flushFdFile(disk);
+
+		/* JĂԂɍ͏oȎ傫Ȃ̂ōȂ */
+		invalidateFdIndex(disk);
+	}
+	if(fclose(disk->fp) != 0)
+		ok = FALSE;
+	disk->fp = NULL;
+	disk->buf_len = disk->buf_pos = 0;
+	return ok;
+}
+
+/*
+	tbs[fBXN (̃t@CĎ)
+*/
+void closeDisk(struct Disk *disk)
+{
+	if(disk->fp != NULL)
+		closeFd(disk);
+	closeFdImage(disk);
+#ifdef __linux__
+	if(disk->inotify >= 0)
+		close(disk->inotify);
+	disk->inotify = -1;
+#endif
+	free(disk->buf);
+	free(disk->files);
+	free(disk->entries);
+	free(disk->hash);
+	disk->buf = disk->files = disk->files_p = NULL;
+	disk->entries = NULL;
+	disk->hash = NULL;
+}
+
 /*
 	tbs[fBXÑt@CI[v
 */
@@ -1105,12 +1827,18 @@ uint8 openFdFile(struct Disk *disk, const uint8 *file, const uint8 *mode)
 	char path[PATH_MAX];
 	struct stat s;
 
+	if(disk->image != NULL)
+		return openFdImageFile(disk, file, mode);
+
 	if(disk->fp != NULL) {
-		fclose(disk->fp);
-		disk->fp = NULL;
+		closeFd(disk);
 		return 0x03; /* NR error */
 	}
 
+	/* obt@͂Ŏ (t@C蒼OɊmۂ) */
+	if(disk->buf == NULL && (disk->buf = malloc(FD_BUFFER)) == NULL)
+		return 0x07; /* PR error */
+
 	getPath(disk, path, file);
 
 	if(*mode == 'R')
@@ -1124,10 +1852,18 @@ uint8 openFdFile(struct Disk *disk, const uint8 *file, const uint8 *mode)
 	if(disk->fp == NULL)
 		return errno == ENOENT ? 0x02/* FL error */: 0x07/* PR error */;
 
-	if(stat(path, &s))
-		return errno == ENOENT ? 0x02/* FL error */: 0x07/* PR error */;
+	if(fstat(fileno(disk->fp), &s))
+		return 0x07; /* PR error */
 	disk->size = s.st_size;
 
+	setvbuf(disk->fp, NULL, _IONBF, 0);
+	disk->buf_len = disk->buf_pos = 0;
+	disk->writing = (*mode != 'R');
+
+	/* ނȂ΍Ȃ */
+	if(disk->writing)
+		invalidateFdIndex(disk);
+
 	disk->pos = 0;
 	return 0x00;
 }
@@ -1137,27 +1873,39 @@ uint8 openFdFile(struct Disk *disk, const uint8 *file, const uint8 *mode)
 */
 uint8 closeFdFile(struct Disk *disk)
 {
+	if(disk->image != NULL)
+		return closeFdImageFile(disk);
+
 	if(disk->fp == NULL)
 		return 0x00;
 
-	fclose(disk->fp);
-	disk->fp = NULL;
+	if(!closeFd(disk))
+		return 0x07; /* PR error */
 	return 0x00;
 }
 
 /*
 	tbs[fBXÑt@Cǂݍ
+	(ROM256oCg][v1memcpyŒuHLE͖. ROM̃AhXKv)
 */
 uint8 readFdFile(struct Disk *disk, uint8 *data)
 {
+	if(disk->image != NULL)
+		return readFdImageFile(disk, data);
+
 	if(disk->fp == NULL)
 		return 0x03; /* NR error */
 
-	if(fread(data, 1, 1, disk->fp) <= 0) {
-		fclose(disk->fp);
-		disk->fp = NULL;
-		return 0x0b; /* DF error */
+	/* obt@Ȃΐǂ݂ */
+	if(disk->buf_pos >= disk->buf_len) {
+		disk->buf_len = fread(disk->buf, 1, FD_BUFFER, disk->fp);
+		disk->buf_pos = 0;
+		if(disk->buf_len == 0) {
+			closeFd(disk);
+			return 0x0b; /* DF error */
+		}
 	}
+	*data = disk->buf[disk->buf_pos++];
 	disk->pos++;
 	return 0x00;
 }
@@ -1167,23 +1915,25 @@ uint8 readFdFile(struct Disk *disk, uint8 *data)
 */
 uint8 writeFdFile(struct Disk *disk, uint8 data, const uint8 *size)
 {
+	if(disk->image != NULL)
+		return writeFdImageFile(disk, data, size);
+
 	if(disk->fp == NULL)
 		return 0x00;
 
-	if(fwrite(&data, 1, 1, disk->fp) <= 0) {
-		fclose(disk->fp);
-		disk->fp = NULL;
+	/* obt@ςȂΏo */
+	if(disk->buf_len >= FD_BUFFER && !flushFdFile(disk)) {
+		closeFd(disk);
 		return 0x07; /* PR error */
 	}
+	disk->buf[disk->buf_len++] = data;
 	disk->pos++;
 
 	if(size != NULL) {
 		size_t last_pos = (size_t )size[0] | ((size_t )size[1] << 8) | ((size_t )size[2] << 16) | ((size_t )size[3] << 24);
 
-		if(disk->pos >= last_pos) {
-			fclose(disk->fp);
-			disk->fp = NULL;
-		}
+		if(disk->pos >= last_pos && !closeFd(disk))
+			return 0x07; /* PR error */
 	}
 	return 0x00;
 }
@@ -1195,6 +1945,10 @@ uint8 renameFdFile(struct Disk *disk, const uint8 *old_file, const uint8 *new_fi
 {
 	char old_path[PATH_MAX], new_path[PATH_MAX];
 
+	if(disk->image != NULL)
+		return renameFdImageFile(disk, old_file, new_file);
+
+	invalidateFdIndex(disk);
 	if(rename(getPath(disk, old_path, old_file), getPath(disk, new_path, new_file)) < 0)
 		return errno == ENOENT ? 0x02/* FL error */: 0x07/* PR error */;
 	return 0x00;
@@ -1206,6 +1960,11 @@ uint8 renameFdFile(struct Disk *disk, const uint8 *old_file, const uint8 *new_fi
 uint8 deleteFdFile(struct Disk *disk, const uint8 *file)
 {
 	char path[PATH_MAX];
+
+	if(disk->image != NULL)
+		return deleteFdImageFile(disk, file);
+
+	invalidateFdIndex(disk);
 	if(unlink(getPath(disk, path, file)) < 0)
 		return errno == ENOENT ? 0x02/* FL error */: 0x07/* PR error */;
 	return 0x00;
@@ -1224,6 +1983,24 @@ static int matchFile(const uint8 *file, const uint8 *wild)
 			return FALSE;
 	return TRUE;
 }
+
+/*
+	t@Cʂ1 (findFdFilẻ)
+*/
+static void setFoundFdFile(uint8 *p, const struct FdEntry *e)
+{
+	memcpy(p, e->file, 11);
+	p += 11;
+	*p++ = 0x00;
+	*p++ = 0x00;
+	*p++ = 0x00;
+	*p++ = 0x00;
+	*p++ = e->size & 0xff;
+	*p++ = (e->size >> 8) & 0xff;
+	*p++ = (e->size >> 16) & 0xff;
+	*p++ = (e->size >> 24) & 0xff;
+	*p++ = e->attr;
+}
 #endif
 
 /*
@@ -1231,6 +2008,9 @@ static int matchFile(const uint8 *file, const uint8 *wild)
 */
 uint8 findFdFile(struct Disk *disk, const uint8 *wild, uint8 *data)
 {
+	if(disk->image != NULL)
+		return findFdImageFile(disk, wild, data);
+
 #ifdef _WIN32
 	int n = 0;
 	char path[PATH_MAX], dir[PATH_MAX], file[PATH_MAX];
@@ -1286,55 +2066,29 @@ uint8 findFdFile(struct Disk *disk, const uint8 *wild, uint8 *data)
 	*data = n;
 	return 0x00;
 #else
-	int n = 0;
-	char path[PATH_MAX], dir[PATH_MAX];
-	uint8 *p;
-	DIR *d;
-	struct dirent *f;
-	struct stat s;
-
-	if(disk->files == NULL)
-		disk->files = malloc(1);
-	else
-		disk->files = realloc(disk->files, 1);
+	const struct FdEntry *e;
+	uint8 *files;
+	int n = 0, i;
 
-	setHomeDir(dir, disk->dir);
-	if((d = opendir(dir)) == NULL) {
+	if(!updateFdIndex(disk) || (files = realloc(disk->files, 20 * disk->entry_count + 1)) == NULL) {
 		disk->files_p = NULL;
 		*data = 0x00;
 		return 0x03;
 	}
+	disk->files = files;
 
-	for(f = readdir(d); f != NULL; f = readdir(d)) {
-		if(f->d_type == DT_DIR || f->d_name[0] == '.')
-			continue;
-
-		sprintf(path, "%s/%s", dir, f->d_name);
-		stat(path, &s);
-		if(s.st_size == 0 || s.st_size > 0xffffffff)
-			continue;
-
-		disk->files = realloc(disk->files, 20 * n + 20);
-		p = disk->files + n * 20;
-		if(!getFdFile(p, f->d_name))
-			continue;
-		if(!matchFile(p, wild))
-			continue;
-		p += 11;
-		*p++ = 0x00;
-		*p++ = 0x00;
-		*p++ = 0x00;
-		*p++ = 0x00;
-		*p++ = s.st_size & 0xff;
-		*p++ = (s.st_size >> 8) & 0xff;
-		*p++ = (s.st_size >> 16) & 0xff;
-		*p++ = (s.st_size >> 24) & 0xff;
-		*p++ = getFileAttr(path);
-		n++;
+	if(memchr(wild, '?', 11) == NULL) {
+		/* ChJ[h܂܂Ȃ΃nbV\T */
+		if((e = lookupFdIndex(disk, wild)) != NULL && e->size > 0)
+			setFoundFdFile(disk->files + n++ * 20, e);
+	} else {
+		for(i = 0; i < disk->entry_count && n < 0xff; i++) {
+			e = &disk->entries[i];
+			if(e->size > 0 && matchFile(e->file, wild))
+				setFoundFdFile(disk->files + n++ * 20, e);
+		}
 	}
 
-	closedir(d);
-
 	disk->files_p = disk->files;
 	*data = n;
 	return 0x00;
@@ -1358,6 +2112,9 @@ uint8 getFoundFdFile(struct Disk *disk, uint8 *data)
 */
 uint8 formatFd(struct Disk *disk)
 {
+	if(disk->image != NULL)
+		return formatFdImage(disk);
+
 	/* Ȃ */
 	return 0x00;
 }
@@ -1367,30 +2124,46 @@ uint8 formatFd(struct Disk *disk)
 */
 void setIOData(struct IOPort *s, const char *path)
 {
-	char buf[256];
-
 	if(path != NULL)
 		strcpy(s->path, path);
 	s->pos = -4;
+	s->shown_pos = -1;
 
-	sprintf(buf, "%s %dbytes", s->path, 0);
-	setTitle(buf);
+	/* ̓t@C͍ŏǂ݂Ȃ */
+	if(s->in != NULL) {
+		fclose(s->in);
+		s->in = NULL;
+	}
+	s->in_top = s->in_len = 0;
+	s->eof = FALSE;
 }
 
 /*
-	̓L[̖̃|C^𓾂()
+	͂̃Cxgǉ (setAutoKeỷ)
 */
-static uint8 *getAutoKeyLast(struct AutoKey *auto_key)
+static int addAutoKeyEvent(struct AutoKey *auto_key, uint8 key, uint8 press, uint64 time)
 {
-	if(auto_key->key == NULL) {
-		auto_key->press = FALSE;
-		auto_key->key = malloc(2);
-		return auto_key->key;
-	} else {
-		int len = strlen((char *)auto_key->key);
-		auto_key->key = realloc(auto_key->key, len + 2);
-		return auto_key->key + len;
+	struct AutoKeyEvent *event;
+	int size, n;
+
+	/* Oobt@tȂΑ傫 */
+	if(auto_key->len == auto_key->size) {
+		size = (auto_key->size == 0 ? AUTOKEY_SIZE: auto_key->size * 2);
+		if((event = realloc(auto_key->event, sizeof(*event) * size)) == NULL)
+			return FALSE;
+		n = auto_key->size - auto_key->top;
+		if(auto_key->len > n)
+			memcpy(event + auto_key->size, event, sizeof(*event) * (auto_key->len - n));
+		auto_key->event = event;
+		auto_key->size = size;
 	}
+
+	event = &auto_key->event[(auto_key->top + auto_key->len) & (auto_key->size - 1)];
+	event->time = time;
+	event->key = key;
+	event->press = press;
+	auto_key->len++;
+	return TRUE;
 }
 
 /*
@@ -1398,10 +2171,17 @@ static uint8 *getAutoKeyLast(struct AutoKey *auto_key)
 */
 void setAutoKey(Z1stat *z1, uint8 key)
 {
-	uint8 *last = getAutoKeyLast(&z1->auto_key);
+	struct AutoKey *auto_key = &z1->auto_key;
+	uint64 time;
 
-	*last++ = key;
-	*last = 0;
+	/* ÕL[𗣂ď\ɎԂoĂ牟 */
+	time = (auto_key->next_time > z1->elapsed_states ? auto_key->next_time: z1->elapsed_states);
+	if(!addAutoKeyEvent(auto_key, key, TRUE, time))
+		return;
+	time += z1->setting.auto_key_press;
+	if(!addAutoKeyEvent(auto_key, key, FALSE, time))
+		return;
+	auto_key->next_time = time + (key == ZKEY_RETURN ? z1->setting.auto_key_return: z1->setting.auto_key_release);
 }
 
 /*
@@ -1796,6 +2576,8 @@ int pressKey(Z1stat *z1, uint8 key)
 		z1->cpu.i.trace = !z1->cpu.i.trace;
 		return -1;
 	}
+	if(key == ZKEY_TURBO)
+		return -1;
 	if(key == ZKEY_REWIND_INPORT) {
 		setIOData(&z1->rs_receive, NULL);
 		return -1;
@@ -1809,6 +2591,8 @@ int pressKey(Z1stat *z1, uint8 key)
 
 	key--;
 	z1->key.matrix[key / 0x10] |= (1 << (key % 0x10));
+	z1->key.rows |= (1 << (key / 0x10));
+	updateKeyMatrix(z1);
 	return 0x0c;
 }
 
@@ -1821,6 +2605,8 @@ int releaseKey(Z1stat *z1, uint8 key)
 		return -1;
 	if(key == ZKEY_DEBUG)
 		return -1;
+	if(key == ZKEY_TURBO)
+		return -1;
 	if(key == ZKEY_REWIND_INPORT)
 		return -1;
 	if(key == ZKEY_REWIND_OUTPORT)
@@ -1829,41 +2615,18 @@ int releaseKey(Z1stat *z1, uint8 key)
 		return -1;
 
 	key--;
-	z1->key.matrix[key / 0x10] &= ~(1 << (key % 0x10));
+	if((z1->key.matrix[key / 0x10] &= ~(1 << (key % 0x10))) == 0)
+		z1->key.rows &= ~(1 << (key / 0x10));
+	updateKeyMatrix(z1);
 	return 0x0c;
 }
 
 /*
-	͂
+	͒?
 */
-int autoUpdateKey(Z1stat *z1)
+int isAutoKey(const Z1stat *z1)
 {
-	struct AutoKey *auto_key = &z1->auto_key;
-	int intr;
-
-	if(auto_key->key == NULL)
-		return -1;
-	if(*auto_key->key == 0) {
-		auto_key->count = 0;
-		free(auto_key->key);
-		auto_key->key = NULL;
-		return -1;
-	}
-
-	if(auto_key->count-- > 0)
-		return 0;
-	if(*auto_key->key == ZKEY_CAPS || *auto_key->key == ZKEY_2ND)
-		auto_key->count = z1->setting.refresh_rate / 20;
-	else
-		auto_key->count = z1->setting.refresh_rate / 10;
-
-	if(auto_key->press) {
-		intr = releaseKey(z1, *auto_key->key);
-		memmove(auto_key->key, auto_key->key + 1, strlen((const char *)auto_key->key + 1) + 1);
-	} else
-		intr = pressKey(z1, *auto_key->key);
-	auto_key->press = !auto_key->press;
-	return intr;
+	return z1->auto_key.len > 0;
 }
 
 /*
@@ -1942,9 +2705,228 @@ static void startIntr(Z1stat *z1, int mask)
 }
 
 /*
-	sXe[g𓾂
+	L[͂̊𔭐
+*/
+void startKeyIntr(Z1stat *z1, int v)
+{
+	switch(v) {
+	case 0x0c: /* L[ */
+		if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->key.control)) {
+			if((z1->key.key_control & 0x02) && !z1->key.key_intr) {
+				startIntr(z1, 0x0010);
+				z1->key.key_intr = TRUE;
+				i86int(&z1->cpu, v);
+			}
+		}
+		break;
+	case 0x02: /* ??? */
+		if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->sw.control)) {
+			startIntr(z1, 0x0020);
+			i86int(&z1->cpu, v);
+		}
+		break;
+	}
+}
+
+/*
+	̎͂܂ł̃Xe[g𓾂 (getExecStates̉)
+*/
+static int getAutoKeyRest(Z1stat *z1)
+{
+	const struct AutoKey *auto_key = &z1->auto_key;
+	uint64 now = z1->elapsed_states, time;
+	int max_states = z1->setting.cpu_clock / 800;
+
+	if(auto_key->len == 0)
+		return max_states;
+	if((time = auto_key->event[auto_key->top].time) <= now)
+		return 1;
+	return (time - now < max_states ? (int )(time - now): max_states);
+}
+
+/*
+	͂ (1sPʂ)
+*/
+static void updateAutoKey(Z1stat *z1)
+{
+	struct AutoKey *auto_key = &z1->auto_key;
+	const struct AutoKeyEvent *event;
+
+	/* 1sPʂ1/ */
+	if(auto_key->len == 0)
+		return;
+	event = &auto_key->event[auto_key->top];
+	if(event->time > z1->elapsed_states)
+		return;
+
+	if(event->press)
+		startKeyIntr(z1, pressKey(z1, event->key));
+	else
+		startKeyIntr(z1, releaseKey(z1, event->key));
+	auto_key->top = (auto_key->top + 1) & (auto_key->size - 1);
+	auto_key->len--;
+}
+
+/*
+	VA|[ǧ݂̃Xe[g𓾂 (UART̉)
+*/
+static uint64 getUARTTime(const Z1stat *z1)
+{
+	return z1->slice_end - z1->cpu.i.states;
+}
+
+/*
+	VA|[g1oCg̑MɂXe[g𓾂 (UART̉)
+*/
+static int getUARTByteStates(const Z1stat *z1)
+{
+	int bits;
+
+	/* X^[grbg+f[^+peB+Xgbvrbg */
+	switch(z1->sio.settings & 0x0007) {
+	case 2:
+	case 3:
+		bits = 11;
+		break;
+	case 4:
+		bits = 9;
+		break;
+	default:
+		bits = 10;
+		break;
+	}
+
+	/* 1rbg̓{[[gJE^8 */
+	return bits * 8 * ((z1->sio.baud & 0x7fff) + 1);
+}
+
+/*
+	VA|[g̎MFIFOɎM (UART̉)
+*/
+static void receiveUART(Z1stat *z1, uint64 now)
+{
+	uint8 x;
+
+	while(z1->sio.rx_len < SIO_FIFO) {
+		if(!z1->setting.sio_unlimited && now < z1->sio.rx_time)
+			return;
+		if(!receiveIOData(&z1->rs_receive, &x))
+			break;
+		z1->sio.rx_fifo[z1->sio.rx_len++] = x;
+		z1->sio.rx_time += getUARTByteStates(z1);
+	}
+
+	/* MĂȂԂ̎Ԃ͋l߂Ȃ */
+	if(z1->sio.rx_time < now)
+		z1->sio.rx_time = now;
+}
+
+/*
+	VA|[g1oCg
+*/
+void writeUART(Z1stat *z1, uint8 x)
+{
+	/* xȂ΂ɑM */
+	if(z1->setting.sio_unlimited) {
+		sendIOData(&z1->rs_send, x);
+		z1->sio.sent = TRUE;
+		return;
+	}
+
+	/* FIFOςȂΎ̂Ă */
+	if(z1->sio.tx_len >= SIO_FIFO)
+		return;
+
+	if(z1->sio.tx_len == 0)
+		z1->sio.tx_time = getUARTTime(z1) + getUARTByteStates(z1);
+	z1->sio.tx_fifo[z1->sio.tx_len++] = x;
+}
+
+/*
+	VA|[g1oCgǂݍ
+*/
+uint8 readUART(Z1stat *z1)
+{
+	if(z1->sio.rx_len > 0) {
+		z1->sio.rx_last = z1->sio.rx_fifo[0];
+		memmove(z1->sio.rx_fifo, z1->sio.rx_fifo + 1, --z1->sio.rx_len);
+	}
+
+	/* xȂ΂Ɏ̃f[^M */
+	if(z1->setting.sio_unlimited)
+		receiveUART(z1, getUARTTime(z1));
+	return z1->sio.rx_last;
+}
+
+/*
+	VA|[g̃Xe[^X𓾂
+*/
+uint8 getUARTStatus(Z1stat *z1)
+{
+	/* MFIFO? */
+	return z1->sio.tx_len == 0 ? 0x08: 0x00;
+}
+
+/*
+	VA|[g̎̑M܂ł̃Xe[g𓾂 (getExecStates̉)
+*/
+static int getUARTRest(Z1stat *z1)
+{
+	uint64 now = z1->elapsed_states;
+	int max_states = z1->setting.cpu_clock / 800, rest = max_states;
+
+	/* xȂΑM͒Z؂ */
+	if(z1->setting.sio_unlimited) {
+		if(z1->sio.rx_len > 0 || z1->sio.intr || peekIOData(&z1->rs_receive, NULL))
+			return SIO_UNLIMITED_STATES;
+		return max_states;
+	}
+
+	if(z1->sio.tx_len > 0 && z1->sio.tx_time < now + rest)
+		rest = z1->sio.tx_time > now ? (int )(z1->sio.tx_time - now): 1;
+	if(z1->sio.rx_len < SIO_FIFO && z1->sio.rx_time < now + rest && peekIOData(&z1->rs_receive, NULL))
+		rest = z1->sio.rx_time > now ? (int )(z1->sio.rx_time - now): 1;
+	return rest;
+}
+
+/*
+	VA|[g̑Mi߂ (1sPʂ)
+*/
+static void updateUART(Z1stat *z1)
+{
+	uint64 now = z1->elapsed_states;
+
+	/* MIf[^o͂ */
+	while(z1->sio.tx_len > 0 && z1->sio.tx_time <= now) {
+		sendIOData(&z1->rs_send, z1->sio.tx_fifo[0]);
+		memmove(z1->sio.tx_fifo, z1->sio.tx_fifo + 1, --z1->sio.tx_len);
+		z1->sio.tx_time += getUARTByteStates(z1);
+		z1->sio.sent = TRUE;
+	}
+
+	/* M */
+	receiveUART(z1, now);
+
+	/* M犄𔭐 */
+	if(z1->sio.sent) {
+		if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->sio.control)) {
+			startIntr(z1, 0x0004);
+			i86int(&z1->cpu, 0x15);
+		}
+		z1->sio.sent = FALSE;
+	} else if(z1->sio.rx_len > 0) {
+		/* M犄𔭐 */
+		if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->sio.control)) {
+			startIntr(z1, 0x0004);
+			i86int(&z1->cpu, 0x14);
+		}
+	}
+}
+
+/*
+	sXe[g𓾂 (execSlicẻ)
 */
-static int getExecStates(Z1stat *z1, int *states)
+static int getExecStates(Z1stat *z1, int max_states, int *states)
 {
 	int rest, r0, r1, r2, v = -1;
 
@@ -1956,6 +2938,18 @@ static int getExecStates(Z1stat *z1, int *states)
 		rest = r0 < r2 ? r0: r2;
 	else
 		rest = r1 < r2 ? r1: r2;
+
+	/* VA|[g̎̑Mŋ؂ */
+	if((r0 = (getUARTRest(z1) + 3) / 4) < rest)
+		rest = r0;
+
+	/* ̎͂ŋ؂ */
+	if((r0 = (getAutoKeyRest(z1) + 3) / 4) < rest)
+		rest = r0;
+
+	/* w肳ꂽXe[gŋ؂ */
+	if((r0 = (max_states + 3) / 4) < rest)
+		rest = r0;
 	if(rest <= 0)
 		rest = 1;
 
@@ -1973,159 +2967,53 @@ static int getExecStates(Z1stat *z1, int *states)
 	return v;
 }
 
-int main(int argc, char *argv[])
+/*
+	1sPʂs
+	߂l: sXe[g (d؂ꂽ-1)
+*/
+int execSlice(Z1stat *z1, int max_states)
 {
-	Z1stat *z1 = malloc(sizeof(Z1stat));
-	int start = -1, states = 0, s, v, i;
-
-#if SDL_MAJOR_VERSION == 1
-#ifdef _WIN32
-	argv = argvToUTF8(argc, argv);
-#endif
-#endif
-
-	/* G~[^ */
-	if(!init(z1, argc, argv))
-		return 1;
+	int s, v, executed;
 
-#if 0
-	writeWave("sound.wav", NULL, 0);
-#endif
+	/* sXe[g𓾂 */
+	if((v = getExecStates(z1, max_states, &s)) >= 0)
+		if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->timer.control)) {
+			startIntr(z1, 0x0001);
+			i86int(&z1->cpu, v);
+		}
 
-	/* RAMǂݍ */
-	memset(z1->memory, 0, sizeof(z1->memory));
-	if(readBin(z1->setting.path_ram, 0x40000, z1->memory) <= 0)
-		for(i = 0; i < 0x20000; i++)
-			z1->memory[i] = i & 0xff;
-
-	for(i = 1; i < argc; i++)
-		if(*argv[i] != '-') {
-			if(readZ1Bin(argv[i], z1->memory, NULL, &start) <= 0) {
-				showError("CANNOT OPEN FILE. (%s)\n", argv[i]);
-				return 1;
-			} else {
-				for(i = i + 1; i < argc; i++)
-					if(*argv[i] != '-')
-						start = atoix(argv[i]);
-			}
+	/* s */
+	z1->cpu.i.states = s;
+	z1->slice_end = z1->elapsed_states + s;
+	if(i86exec(&z1->cpu) == I86_HALT) {
+		if((z1->power & 0x0001) && !(z1->cpu.r16.f & 0x0200)) {
+			z1->run.off = TRUE;
+			return -1;
 		}
 
-	/* ROMǂݍ */
-	if(strcmp(z1->setting.path_rom, "") == 0) {
-		if(start < 0) {
-			showError("NO ROM IMAGE.\n");
-			return 1;
+		if(z1->run.start >= 0) {
+			z1->cpu.r16.cs = 0;
+			z1->cpu.r16.ip = z1->run.start;
+			z1->cpu.r16.hlt = 0;
+			z1->run.start = -1;
 		}
-		z1->cpu.i.bios = TRUE;
-	} else if(readROM(z1->setting.path_rom, z1->memory + 0x40000) <= 0) {
-		showError("CANNOT OPEN ROM IMAGE FILE. (%s)\n", z1->setting.path_rom);
-		if(start < 0)
-			return 1;
-		z1->cpu.i.bios = TRUE;
-	} else
-		z1->cpu.i.bios = FALSE;
-
-	if(z1->cpu.i.bios) {
-		memcpy(z1->memory + 0x40000, pseudoROM, sizeof(pseudoROM));
-		memset(z1->memory + 0x50000, 0xcf, 1);
-	}
-
-	/* Zbg */
-	i86reset(&z1->cpu);
-
-	if(z1->cpu.i.bios) {
-		z1->cpu.r16.cs = 0;
-		z1->cpu.r16.ip = start;
-		start = -1;
-	}
-
-	for(;;) {
-		/* 1҂ */
-		do {
-			states += z1->setting.cpu_clock / z1->setting.refresh_rate;
-			if(z1->auto_key.key == NULL)
-				delay(1000 / z1->setting.refresh_rate);
-		} while(states < 0);
-
-		do {
-			/* sXe[g𓾂 */
-			if((v = getExecStates(z1, &s)) >= 0)
-				if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->timer.control)) {
-					startIntr(z1, 0x0001);
-					i86int(&z1->cpu, v);
-				}
-
-			/* s */
-			z1->cpu.i.states = s;
-			if(i86exec(&z1->cpu) == I86_HALT) {
-				if((z1->power & 0x0001) && !(z1->cpu.r16.f & 0x0200))
-					goto last;
-
-				if(start >= 0) {
-					z1->cpu.r16.cs = 0;
-					z1->cpu.r16.ip = start;
-					z1->cpu.r16.hlt = 0;
-					start = -1;
-				}
-			}
+	}
 
-			/* ^C}JE^Đݒ肷 */
-			z1->timer.t0.count = getTimerCount(z1, &z1->timer.t0);
-			z1->timer.t1.count = getTimerCount(z1, &z1->timer.t1);
-			z1->timer.t2.count = getTimerCount(z1, &z1->timer.t2);
-
-			/* VA|[gɑM犄𔭐 */
-			if(z1->sio.sent) {
-				if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->sio.control)) {
-					startIntr(z1, 0x0004);
-					i86int(&z1->cpu, 0x15);
-				}
-				z1->sio.sent = FALSE;
-			}
+	/* ^C}JE^Đݒ肷 */
+	z1->timer.t0.count = getTimerCount(z1, &z1->timer.t0);
+	z1->timer.t1.count = getTimerCount(z1, &z1->timer.t1);
+	z1->timer.t2.count = getTimerCount(z1, &z1->timer.t2);
 
-			/* csXe[g炷 */
-			states -= (s - z1->cpu.i.states);
-		} while(states > 0);
-
-		/* TEhobt@؂ւ */
-		flipSoundBuffer(z1);
-
-		/* ʂXV */
-		updateLCD(z1);
-
-		/* L[XV */
-		switch((v = updateKey(z1))) {
-		case 0x0c: /* L[ */
-			if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->key.control)) {
-				if((z1->key.key_control & 0x02) && !z1->key.key_intr) {
-					startIntr(z1, 0x0010);
-					z1->key.key_intr = TRUE;
-					i86int(&z1->cpu, v);
-				}
-			}
-			break;
-		case 0x02: /* ??? */
-			if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->sw.control)) {
-				startIntr(z1, 0x0020);
-				i86int(&z1->cpu, v);
-			}
-			break;
-		}
+	/* o߃Xe[gi߂ */
+	executed = s - z1->cpu.i.states;
+	z1->elapsed_states += executed;
 
-		/* VA|[gM */
-		if((z1->cpu.r16.f & 0x0200) && checkIntr(z1, &z1->sio.control)) {
-			if(peekIOData(&z1->rs_receive, NULL)) {
-				startIntr(z1, 0x0004);
-				i86int(&z1->cpu, 0x14);
-			}
-		}
-	}
-last:;
+	/* VA|[g𑗎M */
+	updateUART(z1);
 
-	/* RAM̓eۑ */
-	if(strcmp(z1->setting.path_ram, "") != 0)
-		writeBin(z1->setting.path_ram, z1->memory, 0x40000);
-	return 0;
+	/* ͂ */
+	updateAutoKey(z1);
+	return executed;
 }
 
 /*
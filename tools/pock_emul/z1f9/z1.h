@@ -7,8 +7,12 @@
 
 #include <stdio.h>
 #include <limits.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "i80x86.h"
 #include "conf.h"
+#include "z1core.h"
 
 /* ^U */
 #define FALSE	0	/* U */
@@ -21,6 +25,25 @@
 #define MACHINE_FX890P	3	/* FX-890P */
 #define MACHINE_FX890P_EN	4	/* FX-890PCOf */
 
+/* \ */
+#define DISPLAY_SURFACE	0	/* EBhET[tFXɕ` */
+#define DISPLAY_TEXTURE	1	/* eNX`g債ĕ` */
+#define DISPLAY_SOFTWARE	2	/* eNX`g債ĕ`(\tgEFA_) */
+
+/* Lv`` */
+#define CAPTURE_NONE	0	/* Lv`Ȃ */
+#define CAPTURE_PBM	1	/* PBM */
+#define CAPTURE_PGM	2	/* PGM */
+#define CAPTURE_PNG	3	/* PNG */
+#define CAPTURE_RAW	4	/* o߃Xe[gVRAMA */
+
+/* x̒ */
+#define PACING_TIMER	0	/* ^C}1҂ */
+#define PACING_AUDIO	1	/* TEh̃Oobt@̎cʂɍ킹 */
+
+/* ^[{ɉʂƃL[XV(Hz) */
+#define TURBO_REFRESH	30
+
 /* LCD */
 #define VRAM_HEIGHT	65	/* VRAM  */
 #define VRAM_WIDTH	32	/* VRAM oCg */
@@ -111,6 +134,7 @@
 #define ZKEY_ANS	0xa8	/* ANSL[ */
 #define ZKEY_TAN	0xaa	/* tanL[ */
 #define ZKEY_SHIFT	0xbc	/* SHIFTL[ */
+#define ZKEY_TURBO	0xf9	/* ^[{zL[ */
 #define ZKEY_COPY	0xfa	/* Rs[zL[ */
 #define ZKEY_PASTE	0xfb	/* \tzL[ */
 #define ZKEY_REWIND_INPORT	0xfc	/* ͊߂zL[ */
@@ -126,6 +150,12 @@
 /* TEh[g(Hz) */
 #define AUDIO_RATE	44100
 
+/* Oobt@̎cʂ̂҂ő̃t[ (΃^C}ő҂) */
+#define AUDIO_WAIT_FRAMES	4
+
+/* 1t[ɋL^uU[̕ω̍ő吔 */
+#define SOUND_EVENTS	4096
+
 /* 傫ق߂ */
 #define MAX(x, y)	((x) > (y) ? (x): (y))
 
@@ -156,21 +186,95 @@ struct Timer {
 		uint16 count; /* JE^ */
 };
 
+/* o̓|[g̏o̓obt@ */
+#define IOPORT_BUFFER	0x4000	/* obt@ */
+#define IOPORT_FLUSH_INTERVAL	100	/* Ԋu(ms) */
+
+/* VA|[gFIFO */
+#define SIO_FIFO	4	/* FIFO */
+#define SIO_UNLIMITED_STATES	128	/* x̂Ƃ̍ősXe[g */
+
+/*  */
+#define AUTOKEY_SIZE	0x400	/* Oobt@̏̑傫(2ׂ̂) */
+
+/*
+	o̓|[g̏Xbh
+*/
+struct IOThread {
+	pthread_t thread; /* o̓Xbh */
+	pthread_mutex_t mutex;
+	pthread_cond_t cond; /* v */
+	pthread_cond_t drained; /*  */
+	int started; /* o̓XbhJn? */
+	int quit; /* I邩? */
+	struct IOPort *out_ports[2]; /* o̓|[g */
+	pthread_t pty_thread; /* [[Xbh */
+	int pty_started; /* [[XbhJn? */
+	int pty_master; /* [[(}X^) */
+	int pty_slave; /* [[(X[u) */
+	uint8 pty_rx[IOPORT_BUFFER]; /* Mσf[^ */
+	int pty_rx_len; /* Mσf[^ */
+	struct IOPort *pty_ports[2]; /* [[ɐڑ|[g(M, M) */
+	const char *pty_link; /* V{bNN */
+};
+
 /*
 	o̓|[g
 */
 struct IOPort {
 	char path[PATH_MAX]; /* o̓t@C̃pX */
 	int pos; /* Ǎʒu */
+	int shown_pos; /* ^Cgɕ\ʒu */
+	FILE *fp; /* o̓t@C */
+	FILE *in; /* ̓t@C */
+	uint8 buf[IOPORT_BUFFER]; /* ҂f[^(o)/ǂ݃f[^() */
+	int len; /* ҂f[^ */
+	int truncate; /* o̓t@C蒼? */
+	int in_top; /* ǂ݃f[^̐擪̈ʒu */
+	int in_len; /* ǂ݃f[^ */
+	int eof; /* ̓t@C̖ɒB? */
+	int pty; /* [[ɐڑĂ邩? */
+	struct IOThread *thread; /* Xbh */
+	int keep; /* o͂t@CłȂɗ߂邩? */
+	uint8 *kept; /* ߂o */
+	int kept_len; /* ߂o͂̒ */
+	int kept_size; /* ߂obt@̑傫 */
+};
+
+/* tbs[fBXÑt@C̓Ǎ/obt@ */
+#define FD_BUFFER	0x10000
+
+/*
+	tbs[fBXN̍̍
+*/
+struct FdEntry {
+	uint8 file[11]; /* t@C */
+	uint8 attr; /*  */
+	uint32 size; /* TCY */
+};
+
+/*
+	I/O|[g̃nh
+*/
+struct IOHandler {
+	uint8 (*in8)(I86stat *, uint16); /* 8bit */
+	int (*out8)(I86stat *, uint16, uint8); /* 8bito */
+	uint16 (*in16)(I86stat *, uint16); /* 16bit(NULLȂ8bit͂2s) */
+	int (*out16)(I86stat *, uint16, uint16); /* 16bito(NULLȂ8bito͂2s) */
 };
 
 /*
 	Z-1/FX-890P̏
 */
-typedef struct {
+struct Z1stat {
 	I86stat cpu; /* CPU */
 	uint8 memory[0x40000 + 0x20000]; /*  */
 
+	uint64 elapsed_states; /* Ňo߃Xe[g */
+	uint64 slice_end; /* s̎IXe[g */
+
+	const struct IOHandler **io[0x100]; /* I/O|[g̃nh(8bitƂ̕\) */
+
 	uint16 power; /* d */
 	uint8 buzzer; /* uU[ */
 
@@ -190,6 +294,13 @@ typedef struct {
 		uint16 control; /* Rg[ */
 		int intr; /* ? */
 		int sent; /* Mς? */
+		uint8 tx_fifo[SIO_FIFO]; /* MFIFO */
+		int tx_len; /* MFIFÕf[^ */
+		uint64 tx_time; /* 擪̃f[^̑MIXe[g */
+		uint8 rx_fifo[SIO_FIFO]; /* MFIFO */
+		int rx_len; /* MFIFÕf[^ */
+		uint64 rx_time; /* ̃f[^̎MIXe[g */
+		uint8 rx_last; /* Ōɓǂݏof[^ */
 	} sio;
 
 	/* J[hGbW */
@@ -202,6 +313,8 @@ typedef struct {
 	struct {
 		uint16 strobe; /* Xg[u */
 		uint16 matrix[12]; /* }gNX */
+		uint16 rows; /* L[Ăs(rbg) */
+		uint16 value; /* L[Ԃ̃|[g̒l */
 		uint16 key_control; /* L[Rg[ */
 		int key_intr; /* L[? */
 		uint16 control; /* Rg[ */
@@ -238,6 +351,9 @@ typedef struct {
 		uint8 op; /* Z */
 		uint8 map; /* Zʂ}bv邩? */
 		uint8 reg[9]; /* WX^ */
+		uint8 valid; /* ZʂL? */
+		uint8 a[16]; /* Z */
+		uint8 f; /* Zʂ̃tO */
 	} cal;
 
 	/* LCD */
@@ -255,30 +371,93 @@ typedef struct {
 	/* v^o̓f[^ */
 	struct IOPort printer;
 
+	/* o̓|[g̏Xbh */
+	struct IOThread io_thread;
+
 	/* tbs[fBXN */
 	struct Disk {
 		char dir[PATH_MAX]; /* ztbs[fBXÑfBNg */
 		FILE *fp; /* I[vt@C̃fBXNv^ */
 		size_t size; /* I[vt@C̃TCY */
 		off_t pos; /* I[vt@C̓Ǎ/ʒu */
+		uint8 *buf; /* Ǎ/obt@ */
+		size_t buf_len; /* obt@̃f[^ */
+		size_t buf_pos; /* obt@̓Ǎʒu */
+		int writing; /* pɃI[v? */
 		int result_count; /* ʓǍJE^ */
 		uint16 len; /* obt@f[^ */
 		uint8 *files; /* t@C */
 		uint8 *files_p; /* t@Cʂ̓ǎ|C^ */
 		uint8 data; /* Ǎf[^ */
+		struct FdEntry *entries; /*  */
+		int entry_count; /* ̍ڐ */
+		int *hash; /* ̃nbV\ */
+		int hash_size; /* nbV\̑傫(2ׂ̂) */
+		int index_valid; /* L? */
+		char index_dir[PATH_MAX]; /* 쐬fBNg */
+		time_t index_mtime; /* 쐬Ƃ̃fBNg̍XV */
+		int inotify; /* fBNgĎinotifỹfBXNv^(Ȃ-1) */
+		uint8 *image; /* fBXNC[W(ȂNULL) */
+		size_t image_size; /* fBXNC[W̑傫 */
+		char image_path[PATH_MAX]; /* fBXNC[W̃pX */
+		uint8 *image_file; /* I[vt@C̃fBNg̍ */
 	} disk;
 
 	/* TEh */
 	struct Sound {
-		int8 *buffer[2]; /* TEhobt@ */
-		int len; /* obt@ */
-		int page; /* Đ̃y[W */
-		int last_states; /* Ōɏo͂_̌o߃Xe[g */
+		int len; /* I[fBIfoCX̃obt@(0ȂΏo͂Ȃ) */
+		int8 *ring; /* TṽOobt@ */
+		int size; /* Oobt@̑傫(2ׂ̂) */
+		atomic_uint read; /* Ǎʒu(Đ) */
+		atomic_uint write; /* ʒu(G~[V) */
+		atomic_uint underrun; /* ĐTvȂ */
+		atomic_uint overrun; /* Oobt@tŎ̂ĂTv */
+		int8 last_sample; /* ŌɃfoCXɓnTv(Đ) */
+		unsigned int shown_underrun; /* \ */
+		unsigned int shown_overrun; /* \Tv */
+		int target; /* x̒ŖڕWɂ郊Oobt@̎c */
 		int8 last_vol; /* Ōɏ񂾃{[ */
-		int last_pos; /* Ōɏ񂾈ʒu */
-		int played; /* Đ? */
+		uint64 frame_states; /* t[̎n܂̃Xe[g */
+		uint64 frame_sample; /* t[̎n܂̃Tvʒu */
+		int8 frame_vol; /* t[̎n܂̃{[ */
+		struct SoundEvent {
+			uint32 states; /* t[̎n܂肩̃Xe[g */
+			int8 vol; /* {[ */
+		} event[SOUND_EVENTS]; /* t[̃{[̕ω */
+		int event_count; /* {[̕ω̐ */
+		float *mix; /* 1t[̉𐶐obt@ */
+		int8 *pcm; /* Tv */
+		int mix_len; /* obt@̒ */
+		float carry; /* ̃t[̐擪̃Tvɉ␳ */
 	} sound;
 
+	/* LCDLv` (Lv`ȂNULL) */
+	struct Capture *capture;
+
+	/* ^ (^ȂNULL) */
+	struct Record *record;
+
+	/* s */
+	struct Run {
+		int frame_rest; /* ̏I܂ł̃Xe[g */
+		int start; /* ŏHALTŎsn߂AhX(Ȃ-1) */
+		int off; /* d؂ꂽ? */
+	} run;
+
+	/* ^[{ */
+	struct Turbo {
+		int on; /* ^[{? */
+		uint32 start_ticks; /* x̊ɂ鎞(~b) */
+		uint64 start_states; /* x̊ɂo߃Xe[g */
+		uint32 shown_ticks; /* ŌɉʂXV(~b) */
+	} turbo;
+
+	/* sx̌v */
+	struct Speed {
+		int64 start_clock; /* vn߂(imb) */
+		uint64 start_states; /* vn߂o߃Xe[g */
+	} speed;
+
 	/* WCXeBbN */
 	struct Joystick {
 		uint8 right;	/* EɊ蓖ĂꂽL[ */
@@ -290,9 +469,15 @@ typedef struct {
 
 	/*  */
 	struct AutoKey {
-		uint8 *key; /* ͒̃L[ */
-		uint8 press; /* Ă邩? */
-		int count; /* ҂JE^ */
+		struct AutoKeyEvent {
+			uint64 time; /* /Xe[g */
+			uint8 key; /* L[ */
+			uint8 press; /* ? */
+		} *event; /* Cxg̃Oobt@ */
+		int size; /* Oobt@̑傫(2ׂ̂) */
+		int top; /* 擪̃Cxg̈ʒu */
+		int len; /* Cxg */
+		uint64 next_time; /* ̃L[Xe[g */
 	} auto_key;
 
 	/* ݒ */
@@ -303,24 +488,78 @@ typedef struct {
 		uint16 iram_size;	/* RAMe */
 		uint16 oram_size;	/* gRAMe */
 		int refresh_rate; /* I/OXV[g(Hz) */
+		int pacing; /* x̒ */
+		int turbo_limit; /* ^[{̑x̏(@̉{, 0ȂΖ) */
 		int zoom; /* LCD{ */
+		int display; /* \ */
+		int render_thread; /* `Xbhg? */
 		int scales;	/* LCDK */
 		char path_rom[PATH_MAX]; /* ROMC[Wt@C̃pX */
 		char path_ram[PATH_MAX]; /* RAMC[Wt@C̃pX */
+		int capture_format; /* Lv`` */
+		char path_capture[PATH_MAX]; /* Lv`̏o͐ */
+		char path_wave[PATH_MAX]; /* ^WAVEt@C̃pX */
+		int sio_unlimited; /* VA|[g̑x𖳐ɂ邩? */
+		int sio_pty; /* VA|[gɋ[[g? */
+		char path_pty_link[PATH_MAX]; /* [[ւ̃V{bNN */
+		char path_floppy_image[PATH_MAX]; /* tbs[fBXNC[W̃pX */
+		int auto_key_press; /* ͂ŃL[Ă鎞(Xe[g) */
+		int auto_key_release; /* ͂ŃL[𗣂Ă鎞(Xe[g) */
+		int auto_key_return; /* ͂ŉsL[𗣂Ă鎞(Xe[g) */
 	} setting;
-} Z1stat;
+};
 
 /* init.c */
+extern const OptTable tableZkey[];
 int getAudioSamples(int *fps);
-int init(Z1stat *, int, char **);
+int init(Z1stat *, const char *, int, char **);
+void term(Z1stat *);
+
+/* io.c */
+int registerIOPort(Z1stat *, uint16, uint16, const struct IOHandler *);
+void updateKeyMatrix(Z1stat *);
+int initIO(Z1stat *);
+
+/* fdimage.c */
+int openFdImage(struct Disk *, const char *);
+void closeFdImage(struct Disk *);
+uint8 getFdImageFreeSize(struct Disk *, uint32 *);
+uint8 openFdImageFile(struct Disk *, const uint8 *, const uint8 *);
+uint8 closeFdImageFile(struct Disk *);
+uint8 readFdImageFile(struct Disk *, uint8 *);
+uint8 writeFdImageFile(struct Disk *, uint8, const uint8 *);
+uint8 renameFdImageFile(struct Disk *, const uint8 *, const uint8 *);
+uint8 deleteFdImageFile(struct Disk *, const uint8 *);
+uint8 findFdImageFile(struct Disk *, const uint8 *, uint8 *);
+uint8 formatFdImage(struct Disk *);
 
 /* depend.c */
 void showError(const char *, ...);
 void updateWindow(Z1stat *);
+void postLCD(Z1stat *);
 int updateKey(Z1stat *);
-void delay(int);
 void setTitle(const char *);
-int initDepend(Z1stat *);
+void setSpeed(int);
+int initDepend(Z1stat *, int, char **);
+
+/* clock.c */
+int64 getClock(void);
+void delay(int);
+uint32 getTicks(void);
+void sleepMs(int);
+
+/* capture.c */
+void captureLCD(Z1stat *);
+void stopCapture(Z1stat *);
+int initCapture(Z1stat *);
+
+/* record.c */
+void recordSound(Z1stat *, const int8 *, int);
+void stopRecord(Z1stat *);
+int initRecord(Z1stat *);
+
+/* wave.c */
+int writeWaveHeader(int, int);
 
 /* z1.c */
 char *getDirName(char *, const char *);
@@ -330,13 +569,22 @@ int sendIOData(struct IOPort *, uint8);
 int peekIOData(struct IOPort *, uint8 *);
 int receiveIOData(struct IOPort *, uint8 *);
 void setIOData(struct IOPort *, const char *);
+void pollIOData(struct IOPort *);
+void stopIOPort(Z1stat *);
+int initIOPort(Z1stat *);
 int64 decodeMan(const uint8 *);
 uint8 *encodeMan(uint8 *, int64);
+uint8 *shiftMan(uint8 *, int);
 void opXY(uint8, const uint8 *, const uint8 *, uint8 *, uint8 *);
+const uint8 *getCalResult(Z1stat *, uint8 *);
 char *decodeReg(char *, const uint8 *);
 char *decodeValue(char *, const uint8 *);
 void writeSound(Z1stat *, uint8);
 void flipSoundBuffer(Z1stat *);
+int getSoundFill(struct Sound *);
+int getSound(struct Sound *, int8 *, int);
+int getLCDFade(const Z1stat *);
+void fadeLCD(struct Lcd *, const uint8 *, uint8, int);
 uint8 getFdFreeSize(struct Disk *, uint32 *);
 uint8 openFdFile(struct Disk *, const uint8 *, const uint8 *);
 uint8 closeFdFile(struct Disk *);
@@ -347,19 +595,20 @@ uint8 deleteFdFile(struct Disk *, const uint8 *);
 uint8 findFdFile(struct Disk *, const uint8 *, uint8 *);
 uint8 getFoundFdFile(struct Disk *, uint8 *);
 uint8 formatFd(struct Disk *);
-int autoUpdateKey(Z1stat *);
+void closeDisk(struct Disk *);
+int isAutoKey(const Z1stat *);
 void setAutoKey(Z1stat *, uint8);
 void setAutoText(Z1stat *, const char *);
 int pressKey(Z1stat *, uint8);
 int releaseKey(Z1stat *, uint8);
-
-#if defined(DEF_GLOBAL)
-#	define EXTERN
-#else
-#	define EXTERN	extern
-#endif
-
-#include "depend.h"
+void startKeyIntr(Z1stat *, int);
+void writeUART(Z1stat *, uint8);
+uint8 readUART(Z1stat *);
+uint8 getUARTStatus(Z1stat *);
+int execSlice(Z1stat *, int);
+
+/* main.c */
+void setTurbo(Z1stat *, int);
 
 #endif
 
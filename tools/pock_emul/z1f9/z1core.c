@@ -0,0 +1,527 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	G~[^{̂API (libz1core)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+#include "z1.h"
+#include "pseudorom.h"
+
+/* XibvVbg̎ʎq */
+#define SNAPSHOT_MAGIC	"Z1SNAP01"
+
+/* XibvVbg */
+struct Snapshot {
+	char magic[8]; /* ʎq */
+	I86stat cpu; /* CPU */
+	int prefix; /* ZOgvtBNẌʒu(Ȃ-1) */
+	uint8 memory[0x40000 + 0x20000]; /*  */
+	uint64 elapsed_states; /* o߃Xe[g */
+	uint8 io[offsetof(struct Z1stat, lcd) - offsetof(struct Z1stat, power)]; /* ӑȕ */
+	int param_p; /* FDD̃p[^̈ʒu */
+	struct Run run; /* s */
+};
+
+/*
+	eLXgt@CꂽoCit@Cǂݍ
+*/
+static size_t readTextBin(const char *path, size_t buf_size, uint8 *buf)
+{
+	FILE *fp;
+	int i, x;
+	uint8 *p = buf;
+	char tmp[256];
+
+	if((fp = fopen(path, "r")) == NULL)
+		return 0;
+
+	while(!feof(fp) && p < buf + buf_size) {
+		fgets(tmp, sizeof(tmp), fp);
+		for(i = 0; i < strlen(tmp); i += 2)
+			if(isalnum(tmp[i])) {
+				sscanf(&tmp[i], "%02x", &x);
+				*p++ = (uint8 )x;
+			} else
+				break;
+	}
+
+	fclose(fp);
+	return (size_t )(p - buf);
+}
+
+/*
+	oCit@Cǂݍ
+*/
+static size_t readBin(const char *path, size_t buf_size, void *buf)
+{
+	FILE *fp;
+	size_t size;
+
+	if((fp = fopen(path, "rb")) == NULL)
+		return 0;
+	size = fread(buf, 1, buf_size, fp);
+	fclose(fp);
+	return size;
+}
+
+/*
+	ROMC[Wǂݍ
+*/
+static size_t readROM(const char *path, uint8 *p)
+{
+	if(readTextBin(path, 0x20000, p) == 0x20000)
+		return TRUE;
+	return readBin(path, 0x20000, p) == 0x20000;
+}
+
+/*
+	wb_toCit@Cǂݍ
+*/
+static size_t readZ1Bin(const char *path, uint8 *mem, int *ret_top, int *ret_start)
+{
+	size_t size;
+	int top, start;
+	uint8 head[16];
+
+	if((size = readBin(path, 16, head)) == 0)
+		return 0;
+	if(memcmp(head, "\xff\xfe", 2) != 0) {
+		top = start = 0x2000;
+		size = readBin(path, 0x40000 - top, mem + top);
+	} else {
+		top = (head[9] << 8U) | head[8];
+		if((start = (head[13] << 8U) | head[12]) == 0)
+			start = 0x2000;
+
+		if((size = readBin(path, 0x40000 - top - 16, mem + top)) < 16)
+			return 0;
+		memmove(mem + top, mem + top + 16, size - 16);
+		size -= 16;
+	}
+
+	if(ret_top != NULL)
+		*ret_top = top;
+	if(ret_start != NULL)
+		*ret_start = start;
+	return size;
+}
+
+/*
+	oCit@C
+*/
+static size_t writeBin(const char *path, const uint8 *p, size_t size)
+{
+	FILE *fp;
+	size_t written;
+
+	if((fp = fopen(path, "wb")) == NULL)
+		return 0;
+	written = fwrite(p, 1, size, fp);
+	fclose(fp);
+
+	return written;
+}
+
+/*
+	}V쐬
+	config: ݒt@C (NULLȂΈ̐ݒ肾g)
+*/
+Z1stat *createZ1(const char *config, int argc, char *argv[])
+{
+	Z1stat *z1;
+
+	if((z1 = malloc(sizeof(Z1stat))) == NULL)
+		return NULL;
+	if(!init(z1, config, argc, argv)) {
+		term(z1);
+		free(z1);
+		return NULL;
+	}
+	return z1;
+}
+
+/*
+	}Vj
+*/
+void destroyZ1(Z1stat *z1)
+{
+	if(z1 == NULL)
+		return;
+	term(z1);
+	free(z1);
+}
+
+/*
+	RAMC[Wǂݍ (ǂݍ߂ȂΏlŖ߂)
+*/
+int loadZ1RAM(Z1stat *z1, const char *path)
+{
+	int i;
+
+	/* 𒼐ڏ̂ŉZʂ̂Ă */
+	z1->cal.valid = FALSE;
+
+	memset(z1->memory, 0, 0x40000);
+	if(path != NULL && readBin(path, 0x40000, z1->memory) > 0)
+		return TRUE;
+
+	for(i = 0; i < 0x20000; i++)
+		z1->memory[i] = i & 0xff;
+	return FALSE;
+}
+
+/*
+	RAMC[Wۑ
+*/
+int saveZ1RAM(const Z1stat *z1, const char *path)
+{
+	return writeBin(path, z1->memory, 0x40000) == 0x40000;
+}
+
+/*
+	wb_toCĩvOǂݍ
+	start: sn߂AhX (Ȃ΃wb_̒l)
+*/
+int loadZ1Program(Z1stat *z1, const char *path, int start)
+{
+	int header_start;
+
+	z1->cal.valid = FALSE;
+
+	if(readZ1Bin(path, z1->memory, NULL, &header_start) <= 0)
+		return FALSE;
+	z1->run.start = (start >= 0 ? start: header_start);
+	return TRUE;
+}
+
+/*
+	ROMC[Wǂݍ
+	path: ROMC[Wt@C (NULLȂ΋[ROMg)
+*/
+int loadZ1ROM(Z1stat *z1, const char *path)
+{
+	if(path == NULL || strcmp(path, "") == 0) {
+		z1->cpu.i.bios = TRUE;
+		memcpy(z1->memory + 0x40000, pseudoROM, sizeof(pseudoROM));
+		memset(z1->memory + 0x50000, 0xcf, 1);
+		return TRUE;
+	}
+
+	if(readROM(path, z1->memory + 0x40000) <= 0)
+		return FALSE;
+	z1->cpu.i.bios = FALSE;
+	return TRUE;
+}
+
+/*
+	Zbg
+	[ROMȂΓǂݍ񂾃vOsn߂
+*/
+void resetZ1(Z1stat *z1)
+{
+	i86reset(&z1->cpu);
+
+	/* getZ1Memoryŏ𔽉f */
+	z1->cal.valid = FALSE;
+
+	if(z1->cpu.i.bios) {
+		z1->cpu.r16.cs = 0;
+		z1->cpu.r16.ip = z1->run.start;
+		z1->run.start = -1;
+	}
+
+	z1->run.frame_rest = z1->setting.cpu_clock / z1->setting.refresh_rate;
+	z1->run.off = FALSE;
+}
+
+/*
+	I/OXVI (runZ1̉)
+*/
+static void endFrame(Z1stat *z1)
+{
+	/* TEhobt@؂ւ */
+	flipSoundBuffer(z1);
+
+	/* Lv` */
+	captureLCD(z1);
+
+	/* VA|[g̓͂̒ǋLmF */
+	pollIOData(&z1->rs_receive);
+}
+
+/*
+	s
+	states: sXe[g, events: ~߂Cxg
+	߂l: ~܂Cxg (w肵Xe[gsȂZ1_EVENT_NONE)
+*/
+int runZ1(Z1stat *z1, long long states, int events)
+{
+	struct Run *run = &z1->run;
+	int typing, sent, printed, s, event = Z1_EVENT_NONE;
+
+	if(run->off)
+		return Z1_EVENT_POWEROFF;
+
+	while(states > 0) {
+		typing = isAutoKey(z1);
+		sent = z1->rs_send.pos;
+		printed = z1->printer.pos;
+
+		/* 1sPʂs */
+		if((s = execSlice(z1, (int )MIN(states, (long long )run->frame_rest))) < 0) {
+			event = Z1_EVENT_POWEROFF;
+			break;
+		}
+		states -= s;
+
+		/* I/OXVI? */
+		if((run->frame_rest -= s) <= 0) {
+			run->frame_rest += z1->setting.cpu_clock / z1->setting.refresh_rate;
+			endFrame(z1);
+			if(events & Z1_EVENT_FRAME) {
+				event = Z1_EVENT_FRAME;
+				break;
+			}
+		}
+
+		/* ͂I? */
+		if((events & Z1_EVENT_INPUT) && typing && !isAutoKey(z1)) {
+			event = Z1_EVENT_INPUT;
+			break;
+		}
+
+		/* o͂? */
+		if((events & Z1_EVENT_OUTPUT) && (z1->rs_send.pos != sent || z1->printer.pos != printed)) {
+			event = Z1_EVENT_OUTPUT;
+			break;
+		}
+	}
+
+	/* TEhobt@؂ւ */
+	flipSoundBuffer(z1);
+	return event;
+}
+
+/*
+	Ňo߃Xe[g𓾂
+*/
+unsigned long long getZ1States(const Z1stat *z1)
+{
+	return z1->elapsed_states;
+}
+
+/*
+	OL[R[h𓾂 (Ȃ0)
+*/
+int getZ1Key(const char *name)
+{
+	const OptTable *p;
+
+	for(p = tableZkey; p->string != NULL; p++)
+		if(strcasecmp(name, p->string) == 0)
+			return p->value;
+	return 0;
+}
+
+/*
+	L[? (pressZ1Key, releaseZ1Keỷ)
+	}gNX̃L[pressKeyzL[󂯕t
+*/
+static int isZ1Key(int key)
+{
+	if(1 <= key && key <= 0xc0)
+		return TRUE;
+	switch(key) {
+	case ZKEY_TURBO:
+	case ZKEY_REWIND_INPORT:
+	case ZKEY_REWIND_OUTPORT:
+	case ZKEY_DEBUG:
+	case ZKEY_OFF:
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+	L[ (ȂL[͖)
+*/
+void pressZ1Key(Z1stat *z1, int key)
+{
+	if(isZ1Key(key))
+		startKeyIntr(z1, pressKey(z1, (uint8 )key));
+}
+
+/*
+	L[𗣂 (ȂL[͖)
+*/
+void releaseZ1Key(Z1stat *z1, int key)
+{
+	if(isZ1Key(key))
+		startKeyIntr(z1, releaseKey(z1, (uint8 )key));
+}
+
+/*
+	(UTF-8)͂
+*/
+void typeZ1Text(Z1stat *z1, const char *utf8)
+{
+	setAutoText(z1, utf8);
+}
+
+/*
+	͒?
+*/
+int isZ1Typing(const Z1stat *z1)
+{
+	return isAutoKey(z1);
+}
+
+/*
+	VRAM𓾂
+	status: V{KCh̏Ԃi[ (NULLȂΊi[Ȃ)
+*/
+const unsigned char *getZ1VRAM(const Z1stat *z1, unsigned char *status)
+{
+	if(status != NULL)
+		*status = z1->vram.status;
+	return z1->vram.vram;
+}
+
+/*
+	𓾂 (RAM 0x00000~0x3ffff, ROM 0x40000~0x5ffff)
+	ƂresetZ1Ăs邱 (ZʂoĂ邽)
+*/
+unsigned char *getZ1Memory(Z1stat *z1)
+{
+	return z1->memory;
+}
+
+/*
+	o̓|[g𓾂 (keepZ1Output, getZ1Output̉)
+*/
+static struct IOPort *getOutputPort(const Z1stat *z1, int port)
+{
+	switch(port) {
+	case Z1_OUTPUT_SIO:
+		return (struct IOPort *)&z1->rs_send;
+	case Z1_OUTPUT_PRINTER:
+		return (struct IOPort *)&z1->printer;
+	default:
+		return NULL;
+	}
+}
+
+/*
+	o͂t@CłȂɗ߂
+*/
+void keepZ1Output(Z1stat *z1, int port)
+{
+	struct IOPort *s;
+
+	if((s = getOutputPort(z1, port)) != NULL)
+		s->keep = TRUE;
+}
+
+/*
+	ɗ߂o͂𓾂
+	len: o͂̒i[
+*/
+const unsigned char *getZ1Output(const Z1stat *z1, int port, int *len)
+{
+	const struct IOPort *s;
+
+	if((s = getOutputPort(z1, port)) == NULL || s->kept == NULL) {
+		*len = 0;
+		return (const unsigned char *)"";
+	}
+	*len = s->kept_len;
+	return s->kept;
+}
+
+/*
+	XibvVbg̑傫𓾂
+*/
+size_t getZ1SnapshotSize(void)
+{
+	return sizeof(struct Snapshot);
+}
+
+/*
+	XibvVbgۑ
+	CPUEEӑȕԂۑ. o̓t@Ctbs[fBXN̏Ԃ͊܂܂Ȃ.
+*/
+void saveZ1Snapshot(const Z1stat *z1, void *buf)
+{
+	struct Snapshot *snap = buf;
+
+	memcpy(snap->magic, SNAPSHOT_MAGIC, sizeof(snap->magic));
+	snap->cpu = z1->cpu;
+	snap->prefix = (z1->cpu.r16.prefix != NULL ? (int )(z1->cpu.r16.prefix - &z1->cpu.r16.cs): -1);
+	memcpy(snap->memory, z1->memory, sizeof(snap->memory));
+	snap->elapsed_states = z1->elapsed_states;
+	memcpy(snap->io, &z1->power, sizeof(snap->io));
+	snap->param_p = (int )(z1->fdd.param_p - z1->fdd.param);
+	snap->run = z1->run;
+}
+
+/*
+	XibvVbgǂݍ
+	st@Cŕۑ̂ǂݍ߂.
+*/
+int loadZ1Snapshot(Z1stat *z1, const void *buf)
+{
+	const struct Snapshot *snap = buf;
+	struct Sound *sound = &z1->sound;
+
+	if(memcmp(snap->magic, SNAPSHOT_MAGIC, sizeof(snap->magic)) != 0)
+		return FALSE;
+
+	z1->cpu = snap->cpu;
+	z1->cpu.m = z1->memory;
+	z1->cpu.i.user_data = z1;
+	z1->cpu.r16.prefix = (snap->prefix >= 0 ? &z1->cpu.r16.cs + snap->prefix: NULL);
+	memcpy(z1->memory, snap->memory, sizeof(snap->memory));
+	z1->elapsed_states = z1->slice_end = snap->elapsed_states;
+	memcpy(&z1->power, snap->io, sizeof(snap->io));
+	z1->fdd.param_p = z1->fdd.param + snap->param_p;
+	z1->run = snap->run;
+
+	/* TEh̃t[߂ */
+	sound->frame_states = z1->elapsed_states;
+	sound->frame_sample = z1->elapsed_states * AUDIO_RATE / z1->setting.cpu_clock;
+	sound->frame_vol = sound->last_vol;
+	sound->event_count = 0;
+	return TRUE;
+}
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
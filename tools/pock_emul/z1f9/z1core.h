@@ -0,0 +1,90 @@
+/*
+	CASIO Z-1/FX-890P emulator
+	G~[^{ (libz1core)
+
+	ϐȂ̂, 1̃vZXłł}V,
+	ʁX̃XbhœƂł. (1̃}V𕡐̃Xbh瓯ɑ삵Ă͂Ȃ)
+*/
+
+#ifndef Z1CORE_H
+#define Z1CORE_H
+
+#include <stddef.h>
+
+/* }V */
+typedef struct Z1stat Z1stat;
+
+/* runZ1Ŏ~߂Cxg */
+#define Z1_EVENT_NONE	0x00	/* w肵Xe[gs */
+#define Z1_EVENT_POWEROFF	0x01	/* d؂ꂽ (Ɏ~߂) */
+#define Z1_EVENT_FRAME	0x02	/* I/OXVI */
+#define Z1_EVENT_INPUT	0x04	/* ͂I */
+#define Z1_EVENT_OUTPUT	0x08	/* VA|[gv^ɏo͂ */
+
+/* o̓|[g */
+#define Z1_OUTPUT_SIO	0	/* VA|[g */
+#define Z1_OUTPUT_PRINTER	1	/* v^ */
+
+/* 쐬Ej */
+Z1stat *createZ1(const char *, int, char *[]);
+void destroyZ1(Z1stat *);
+
+/* ǍEۑ */
+int loadZ1RAM(Z1stat *, const char *);
+int saveZ1RAM(const Z1stat *, const char *);
+int loadZ1Program(Z1stat *, const char *, int);
+int loadZ1ROM(Z1stat *, const char *);
+
+/* s */
+void resetZ1(Z1stat *);
+int runZ1(Z1stat *, long long, int);
+unsigned long long getZ1States(const Z1stat *);
+
+/* L[ */
+int getZ1Key(const char *);
+void pressZ1Key(Z1stat *, int);
+void releaseZ1Key(Z1stat *, int);
+void typeZ1Text(Z1stat *, const char *);
+int isZ1Typing(const Z1stat *);
+
+/* VRAME */
+const unsigned char *getZ1VRAM(const Z1stat *, unsigned char *);
+unsigned char *getZ1Memory(Z1stat *);
+
+/* o */
+void keepZ1Output(Z1stat *, int);
+const unsigned char *getZ1Output(const Z1stat *, int, int *);
+
+/* XibvVbg */
+size_t getZ1SnapshotSize(void);
+void saveZ1Snapshot(const Z1stat *, void *);
+int loadZ1Snapshot(Z1stat *, const void *);
+
+#endif
+
+/*
+	Copyright 2009~2019 maruhiro
+	All rights reserved. 
+
+	Redistribution and use in source and binary forms, 
+	with or without modification, are permitted provided that 
+	the following conditions are met: 
+
+	 1. Redistributions of source code must retain the above copyright notice, 
+	    this list of conditions and the following disclaimer. 
+
+	 2. Redistributions in binary form must reproduce the above copyright notice, 
+	    this list of conditions and the following disclaimer in the documentation 
+	    and/or other materials provided with the distribution. 
+
+	THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+	INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+	FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL 
+	THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+	PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+	OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+	WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+	OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+	ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Create, inspect and convert z1f9 single-file floppy images.
+
+The emulator mounts an image with ``floppy_image <path>`` instead of
+``floppy_dir``.  This tool converts between an image and a plain host
+directory, using the same 8.3 name mapping as the directory backend
+(upper-case names only, half-width katakana for codes A1h-EFh).
+
+Layout (all integers little-endian, see fdimage.c):
+
+    header     64 bytes   "Z1FDIMG\\0", version, entries, data offset,
+                          data size, data used
+    directory  32 bytes per entry: name[11], attr ('A'/'B', 0 = free),
+                          offset, size
+    data       data size bytes
+"""
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+from typing import Iterator, List, Optional, Tuple
+
+MAGIC = b"Z1FDIMG\0"
+VERSION = 1
+HEADER_SIZE = 64
+ENTRY_SIZE = 32
+HEADER = struct.Struct("<8sHHIII")
+ENTRY = struct.Struct("<11sBII")
+
+
+def host_to_fd_name(name: str) -> Optional[bytes]:
+    """Map a host file name to the 11-byte floppy name, or None if it does not fit."""
+    def to_ank(text: str) -> Optional[bytes]:
+        out = bytearray()
+        for ch in text:
+            code = ord(ch)
+            if code < 0x80:
+                if ch.isalpha() and ch.islower():
+                    return None
+                out.append(code)
+            elif 0xFF61 <= code <= 0xFF9F:
+                out.append(code - 0xFF60 + 0xA0)
+            else:
+                out.append(ord("_"))
+        return bytes(out)
+
+    base, dot, ext = name.partition(".")
+    if not base or "." in ext or " " in name:
+        return None
+    base_ank, ext_ank = to_ank(base), to_ank(ext)
+    if base_ank is None or ext_ank is None or len(base_ank) > 8 or len(ext_ank) > 3:
+        return None
+    return base_ank.ljust(8, b" ") + ext_ank.ljust(3, b" ")
+
+
+def fd_to_host_name(fd_name: bytes) -> str:
+    """Map an 11-byte floppy name back to a host file name."""
+    def from_ank(raw: bytes) -> str:
+        return "".join(chr(b) if b < 0x80 else chr(0xFF60 + b - 0xA0) if 0xA1 <= b <= 0xEF else "_" for b in raw)
+
+    base = from_ank(fd_name[:8].rstrip(b" "))
+    ext = from_ank(fd_name[8:].rstrip(b" "))
+    return f"{base}.{ext}" if ext else base
+
+
+def file_attr(data: bytes) -> int:
+    return ord("B") if data[:2] == b"\xff\xfe" else ord("A")
+
+
+def read_image(path: Path) -> Tuple[bytes, int, int, int]:
+    image = path.read_bytes()
+    magic, version, entries, data_offset, data_size, _ = HEADER.unpack_from(image)
+    if magic != MAGIC or version != VERSION:
+        raise SystemExit(f"{path}: not a z1f9 floppy image")
+    return image, entries, data_offset, data_size
+
+
+def iter_entries(image: bytes, entries: int, data_offset: int) -> Iterator[Tuple[bytes, int, bytes]]:
+    for i in range(entries):
+        name, attr, offset, size = ENTRY.unpack_from(image, HEADER_SIZE + i * ENTRY_SIZE)
+        if attr:
+            yield name, attr, image[data_offset + offset:data_offset + offset + size]
+
+
+def build_image(files: List[Tuple[bytes, bytes]], entries: int, data_size: int) -> bytes:
+    data_offset = HEADER_SIZE + entries * ENTRY_SIZE
+    used = sum(len(data) for _, data in files)
+    if len(files) > entries:
+        raise SystemExit(f"too many files ({len(files)} > {entries} entries)")
+    if used > data_size:
+        raise SystemExit(f"files do not fit ({used} > {data_size} bytes)")
+
+    image = bytearray(data_offset + data_size)
+    HEADER.pack_into(image, 0, MAGIC, VERSION, entries, data_offset, data_size, used)
+    offset = 0
+    for i, (name, data) in enumerate(files):
+        ENTRY.pack_into(image, HEADER_SIZE + i * ENTRY_SIZE, name, file_attr(data), offset, len(data))
+        image[data_offset + offset:data_offset + offset + len(data)] = data
+        offset += len(data)
+    return bytes(image)
+
+
+def cmd_create(args: argparse.Namespace) -> int:
+    Path(args.image).write_bytes(build_image([], args.entries, args.size * 1024))
+    return 0
+
+
+def cmd_pack(args: argparse.Namespace) -> int:
+    files: List[Tuple[bytes, bytes]] = []
+    for path in sorted(Path(args.dir).iterdir()):
+        if not path.is_file() or path.name.startswith("."):
+            continue
+        fd_name = host_to_fd_name(path.name)
+        if fd_name is None:
+            print(f"skipped (not an 8.3 upper-case name): {path.name}", file=sys.stderr)
+            continue
+        files.append((fd_name, path.read_bytes()))
+    Path(args.image).write_bytes(build_image(files, args.entries, args.size * 1024))
+    return 0
+
+
+def cmd_unpack(args: argparse.Namespace) -> int:
+    image, entries, data_offset, _ = read_image(Path(args.image))
+    out = Path(args.dir)
+    out.mkdir(parents=True, exist_ok=True)
+    for name, _, data in iter_entries(image, entries, data_offset):
+        (out / fd_to_host_name(name)).write_bytes(data)
+    return 0
+
+
+def cmd_list(args: argparse.Namespace) -> int:
+    image, entries, data_offset, data_size = read_image(Path(args.image))
+    used = 0
+    for name, attr, data in iter_entries(image, entries, data_offset):
+        print(f"{fd_to_host_name(name):<12} {chr(attr)} {len(data):>8}")
+        used += len(data)
+    print(f"{(data_size - used) // 1024} KB free")
+    return 0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = ap.add_subparsers(dest="command", required=True)
+
+    def add_geometry(p: argparse.ArgumentParser) -> None:
+        p.add_argument("--size", type=int, default=1440, help="Data area size in KB (default: 1440).")
+        p.add_argument("--entries", type=int, default=256, help="Directory entries (default: 256).")
+
+    p = sub.add_parser("create", help="Create an empty image.")
+    p.add_argument("image")
+    add_geometry(p)
+    p.set_defaults(func=cmd_create)
+
+    p = sub.add_parser("pack", help="Create an image from the files in a directory.")
+    p.add_argument("dir")
+    p.add_argument("image")
+    add_geometry(p)
+    p.set_defaults(func=cmd_pack)
+
+    p = sub.add_parser("unpack", help="Extract the files of an image into a directory.")
+    p.add_argument("image")
+    p.add_argument("dir")
+    p.set_defaults(func=cmd_unpack)
+
+    p = sub.add_parser("list", help="List the files of an image.")
+    p.add_argument("image")
+    p.set_defaults(func=cmd_list)
+
+    args = ap.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())